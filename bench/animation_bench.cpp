@@ -0,0 +1,172 @@
+#include "animation/matrix_batch.hpp"
+
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Flattened skeleton shared by every yacht, parents before children as Model bakes it
+struct Skeleton
+{
+    std::vector<int> order, parents;
+    std::vector<glm::mat4> bind;
+    int driven[7];
+};
+
+// Physics inputs of a batch of yachts
+struct YachtBatch
+{
+    std::vector<glm::vec3> pos;
+    std::vector<glm::quat> rot;
+    std::vector<float> angles; // Steering, wheel, mast, boom and sail, five per yacht
+    std::vector<glm::mat4> models, palettes;
+};
+
+static Skeleton makeSkeleton(std::mt19937 &rng, int boneCount)
+{
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    Skeleton skeleton;
+    for (int b = 0; b < boneCount; b++)
+    {
+        // Palette index differs from the flat index, as it does in the models
+        skeleton.order.push_back((b * 5) % boneCount);
+        skeleton.parents.push_back(b == 0 ? -1 : skeleton.order[(b - 1) / 2]);
+
+        glm::mat4 offset = glm::translate(glm::mat4(1.0f), glm::vec3(unit(rng), unit(rng), unit(rng)));
+        skeleton.bind.push_back(glm::rotate(offset, unit(rng), glm::normalize(glm::vec3(unit(rng), unit(rng), 1.0f))));
+    }
+
+    for (int d = 0; d < 7; d++)
+        skeleton.driven[d] = skeleton.order[1 + d];
+
+    return skeleton;
+}
+
+// Animation as it was, glm::translate * glm::toMat4 for the body, glm::rotate per bone and glm products down the hierarchy
+static void animateBefore(YachtBatch &batch, const Skeleton &skeleton)
+{
+    size_t boneCount = skeleton.order.size();
+
+    for (size_t y = 0; y < batch.pos.size(); y++)
+    {
+        const float *a = &batch.angles[5 * y];
+        glm::mat4 *palette = &batch.palettes[y * boneCount];
+
+        batch.models[y] = glm::translate(glm::mat4(1.0f), batch.pos[y]) * glm::toMat4(batch.rot[y]);
+
+        std::fill(palette, palette + boneCount, glm::mat4(1.0f));
+        palette[skeleton.driven[0]] = glm::rotate(glm::mat4(1.0f), glm::radians(a[0] * 2), glm::vec3(0.0f, -1.0f, 0.0f));
+        palette[skeleton.driven[1]] = glm::rotate(glm::mat4(1.0f), glm::radians(a[1]), glm::vec3(0.0f, 1.0f, 0.0f));
+        palette[skeleton.driven[2]] = glm::rotate(glm::mat4(1.0f), glm::radians(a[1]), glm::vec3(0.0f, 1.0f, 0.0f));
+        palette[skeleton.driven[3]] = glm::rotate(glm::mat4(1.0f), glm::radians(-a[1]), glm::vec3(0.0f, 1.0f, 0.0f));
+        palette[skeleton.driven[4]] = glm::rotate(glm::mat4(1.0f), a[2], glm::vec3(0.0f, 1.0f, 0.0f));
+        palette[skeleton.driven[5]] = glm::rotate(glm::mat4(1.0f), a[3] - a[2], glm::vec3(0.0f, 0.0f, 1.0f));
+        palette[skeleton.driven[6]] = glm::rotate(glm::mat4(1.0f), a[4] - a[2], glm::vec3(0.0f, 0.0f, 1.0f));
+
+        for (size_t i = 0; i < boneCount; i++)
+        {
+            glm::mat4 &bone = palette[skeleton.order[i]];
+            if (skeleton.parents[i] < 0)
+                bone = skeleton.bind[i] * bone;
+            else
+                bone = palette[skeleton.parents[i]] * skeleton.bind[i] * bone;
+        }
+    }
+}
+
+// Animation as Animation::updateYachtBones does it now, one compose batch per yacht and the chain kernel
+static void animateAfter(YachtBatch &batch, const Skeleton &skeleton)
+{
+    size_t boneCount = skeleton.order.size();
+
+    for (size_t y = 0; y < batch.pos.size(); y++)
+    {
+        const float *a = &batch.angles[5 * y];
+        glm::mat4 *palette = &batch.palettes[y * boneCount];
+
+        glm::vec3 positions[8] = {};
+        glm::quat rotations[8];
+        glm::mat4 transforms[8];
+
+        positions[0] = batch.pos[y];
+        rotations[0] = batch.rot[y];
+        rotations[1] = glm::angleAxis(glm::radians(a[0] * 2), glm::vec3(0.0f, -1.0f, 0.0f));
+        rotations[2] = glm::angleAxis(glm::radians(a[1]), glm::vec3(0.0f, 1.0f, 0.0f));
+        rotations[3] = glm::angleAxis(glm::radians(a[1]), glm::vec3(0.0f, 1.0f, 0.0f));
+        rotations[4] = glm::angleAxis(glm::radians(-a[1]), glm::vec3(0.0f, 1.0f, 0.0f));
+        rotations[5] = glm::angleAxis(a[2], glm::vec3(0.0f, 1.0f, 0.0f));
+        rotations[6] = glm::angleAxis(a[3] - a[2], glm::vec3(0.0f, 0.0f, 1.0f));
+        rotations[7] = glm::angleAxis(a[4] - a[2], glm::vec3(0.0f, 0.0f, 1.0f));
+
+        MatrixBatch::compose(positions, rotations, 8, transforms);
+        batch.models[y] = transforms[0];
+
+        std::fill(palette, palette + boneCount, glm::mat4(1.0f));
+        for (int d = 0; d < 7; d++)
+            palette[skeleton.driven[d]] = transforms[1 + d];
+
+        MatrixBatch::chain(skeleton.bind.data(), skeleton.order.data(), skeleton.parents.data(), boneCount, palette);
+    }
+}
+
+static float maxDifference(const std::vector<glm::mat4> &a, const std::vector<glm::mat4> &b)
+{
+    float diff = 0.0f;
+    for (size_t m = 0; m < a.size(); m++)
+        for (int c = 0; c < 4; c++)
+            for (int r = 0; r < 4; r++)
+                diff = std::max(diff, std::fabs(a[m][c][r] - b[m][c][r]));
+    return diff;
+}
+
+// Times the yacht pose and palette update before and after the batch kernels
+int main()
+{
+    const int boneCount = 12;
+    const int repeats = 200;
+
+    std::mt19937 rng(42);
+    Skeleton skeleton = makeSkeleton(rng, boneCount);
+
+    std::printf("%8s %14s %14s %14s %14s\n", "yachts", "ns/yacht before", "ns/yacht after", "max model diff", "max bone diff");
+
+    for (int yachtCount : {100, 1000, 10000})
+    {
+        std::uniform_real_distribution<float> angle(-glm::pi<float>(), glm::pi<float>());
+        std::uniform_real_distribution<float> coordinate(-500.0f, 500.0f);
+
+        YachtBatch before;
+        for (int i = 0; i < yachtCount; i++)
+        {
+            before.pos.push_back(glm::vec3(coordinate(rng), coordinate(rng), 0.0f));
+            before.rot.push_back(glm::angleAxis(angle(rng), glm::normalize(glm::vec3(angle(rng), angle(rng), 10.0f))));
+            for (int a = 0; a < 5; a++)
+                before.angles.push_back(angle(rng));
+        }
+        before.models.resize(yachtCount);
+        before.palettes.resize(yachtCount * boneCount);
+        YachtBatch after = before;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; r++)
+            animateBefore(before, skeleton);
+        double beforeNs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1e9 / (repeats * yachtCount);
+
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; r++)
+            animateAfter(after, skeleton);
+        double afterNs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1e9 / (repeats * yachtCount);
+
+        std::printf("%8d %14.1f %14.1f %14.2e %14.2e\n", yachtCount, beforeNs, afterNs,
+                    maxDifference(before.models, after.models), maxDifference(before.palettes, after.palettes));
+    }
+
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "physics/broadphase.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Naive all pairs test, for comparison
+static size_t naivePairs(const std::vector<glm::vec3> &centers, const std::vector<float> &radii)
+{
+    size_t pairs = 0;
+    for (size_t a = 0; a < centers.size(); a++)
+        for (size_t b = a + 1; b < centers.size(); b++)
+        {
+            glm::vec3 d = glm::abs(centers[a] - centers[b]);
+            float r = radii[a] + radii[b];
+            if (d.x <= r && d.y <= r && d.z <= r)
+                pairs++;
+        }
+    return pairs;
+}
+
+// Times broadphase updates of moving yachts against yacht count and spacing
+int main()
+{
+    const std::vector<int> yachtCounts = {100, 1000, 5000, 20000};
+    const std::vector<float> spacings = {4.0f, 10.0f, 25.0f};
+    const int ticks = 100;
+    const float tickTime = 1.0f / 30.0f;
+    const float radius = 3.0f;
+
+    std::printf("%8s %10s %12s %14s %14s\n", "yachts", "spacing m", "pairs/tick", "us/tick hash", "us/tick naive");
+
+    for (int yachtCount : yachtCounts)
+        for (float spacing : spacings)
+        {
+            std::mt19937 rng(1234);
+            float side = std::sqrt(static_cast<float>(yachtCount)) * spacing;
+            std::uniform_real_distribution<float> position(0.0f, side);
+            std::uniform_real_distribution<float> velocity(-10.0f, 10.0f);
+
+            std::vector<glm::vec3> centers(yachtCount);
+            std::vector<glm::vec3> velocities(yachtCount);
+            std::vector<float> radii(yachtCount, radius);
+            for (int i = 0; i < yachtCount; i++)
+            {
+                centers[i] = glm::vec3(position(rng), position(rng), 1.0f);
+                velocities[i] = glm::vec3(velocity(rng), velocity(rng), 0.0f);
+            }
+
+            Broadphase broadphase;
+            broadphase.setCellSize(2.0f * radius);
+            broadphase.update(centers.data(), radii.data(), centers.size());
+
+            double hashSeconds = 0.0;
+            size_t pairCount = 0;
+
+            for (int t = 0; t < ticks; t++)
+            {
+                for (int i = 0; i < yachtCount; i++)
+                    centers[i] += velocities[i] * tickTime;
+
+                auto start = std::chrono::steady_clock::now();
+                broadphase.update(centers.data(), radii.data(), centers.size());
+                hashSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                pairCount += broadphase.getPairs().size();
+            }
+
+            // Naive loop gets slow quickly, only time a few ticks
+            char naive[32] = "-";
+            if (yachtCount <= 5000)
+            {
+                auto start = std::chrono::steady_clock::now();
+                size_t naiveCount = 0;
+                for (int t = 0; t < 3; t++)
+                    naiveCount += naivePairs(centers, radii);
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                std::snprintf(naive, sizeof(naive), "%.1f", seconds * 1e6 / 3);
+
+                if (naiveCount / 3 != broadphase.getPairs().size())
+                    std::printf("pair count mismatch: %zu vs %zu\n", naiveCount / 3, broadphase.getPairs().size());
+            }
+
+            std::printf("%8d %10.0f %12.1f %14.1f %14s\n", yachtCount, spacing, static_cast<double>(pairCount) / ticks,
+                        hashSeconds * 1e6 / ticks, naive);
+        }
+
+    return 0;
+}
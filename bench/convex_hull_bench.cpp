@@ -0,0 +1,121 @@
+#include "physics/convex_hull.hpp"
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Mesh positions of a whole file, like the hitbox fallback to the lowest LOD
+static void collectPoints(aiNode *node, const aiScene *scene, std::vector<glm::vec3> &points)
+{
+    for (unsigned int i = 0; i < node->mNumMeshes; i++)
+    {
+        aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
+        for (unsigned int v = 0; v < mesh->mNumVertices; v++)
+            points.push_back(glm::vec3(mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z));
+    }
+
+    for (unsigned int i = 0; i < node->mNumChildren; i++)
+        collectPoints(node->mChildren[i], scene, points);
+}
+
+// Old support mapping, a scan over every hitbox point
+static int scanPoints(const std::vector<glm::vec3> &points, const glm::vec3 &direction)
+{
+    int best = 0;
+    float bestDot = glm::dot(points[0], direction);
+    for (int i = 1; i < static_cast<int>(points.size()); i++)
+    {
+        float dot = glm::dot(points[i], direction);
+        if (dot > bestDot)
+        {
+            bestDot = dot;
+            best = i;
+        }
+    }
+    return best;
+}
+
+template <typename Query>
+static double timeQueries(const std::vector<glm::vec3> &directions, Query query, float &checksum)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &direction : directions)
+        checksum += query(direction);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1e9 / directions.size();
+}
+
+// Times ground support queries on the yacht meshes, full point scan against hull hill climbing
+int main(int argc, char **argv)
+{
+    std::string yachtDir = argc > 1 ? argv[1] : "resources/models/yachts";
+    const int ticks = 100000;
+
+    // Down direction in model space of a yacht that rolls, pitches and turns a little every tick
+    std::vector<glm::vec3> directions(ticks);
+    for (int t = 0; t < ticks; t++)
+    {
+        float time = t / 30.0f;
+        glm::quat rot = glm::angleAxis(0.3f * time, glm::vec3(0, 0, 1)) *
+                        glm::angleAxis(0.2f * std::sin(1.3f * time), glm::vec3(1, 0, 0)) *
+                        glm::angleAxis(0.1f * std::sin(0.7f * time), glm::vec3(0, 1, 0));
+        directions[t] = glm::conjugate(rot) * glm::vec3(0, 0, -1);
+    }
+
+    std::printf("%-12s %8s %8s %10s %12s %12s %12s\n", "yacht", "points", "hull", "build ms", "ns scan", "ns climb", "ns warm");
+
+    for (const auto &dir : std::filesystem::directory_iterator(yachtDir))
+    {
+        if (!dir.is_directory())
+            continue;
+
+        std::string name = dir.path().filename().string();
+        std::string path = (dir.path() / (name + "-lod1.dae")).string();
+        if (!std::filesystem::exists(path))
+            path = (dir.path() / (name + ".dae")).string();
+
+        Assimp::Importer importer;
+        const aiScene *scene = importer.ReadFile(path, aiProcess_Triangulate);
+        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+        {
+            std::printf("Assimp Error (%s): %s\n", path.c_str(), importer.GetErrorString());
+            continue;
+        }
+
+        std::vector<glm::vec3> points;
+        collectPoints(scene->mRootNode, scene, points);
+        if (points.empty())
+            continue;
+
+        auto start = std::chrono::steady_clock::now();
+        ConvexHull hull = ConvexHull::build(points);
+        double buildMs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1e3;
+
+        float scanSum = 0.0f, climbSum = 0.0f, warmSum = 0.0f;
+        double scanNs = timeQueries(directions, [&](const glm::vec3 &d)
+                                    { return glm::dot(points[scanPoints(points, d)], d); }, scanSum);
+        double climbNs = timeQueries(directions, [&](const glm::vec3 &d)
+                                     { return glm::dot(hull.vertices[hull.support(d)], d); }, climbSum);
+        int last = 0;
+        double warmNs = timeQueries(directions, [&](const glm::vec3 &d)
+                                    { last = hull.support(d, last);
+                                      return glm::dot(hull.vertices[last], d); }, warmSum);
+
+        // All three must find the same support distance
+        if (std::abs(scanSum - climbSum) > 1e-3f * std::abs(scanSum) + 1e-3f || std::abs(scanSum - warmSum) > 1e-3f * std::abs(scanSum) + 1e-3f)
+            std::printf("support mismatch for %s: %f %f %f\n", name.c_str(), scanSum, climbSum, warmSum);
+
+        std::printf("%-12s %8zu %8zu %10.2f %12.1f %12.1f %12.1f\n", name.c_str(), points.size(), hull.vertices.size(),
+                    buildMs, scanNs, climbNs, warmNs);
+    }
+
+    return 0;
+}
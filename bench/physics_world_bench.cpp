@@ -0,0 +1,82 @@
+#include "physics/physics_world.hpp"
+#include "thread_manager/worker_pool.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+// Steps worlds of increasing yacht count and reports physics throughput per thread count
+int main(int argc, char **argv)
+{
+    const std::vector<int> yachtCounts = {1, 10, 100, 1000, 10000};
+    const double minSeconds = argc > 1 ? std::atof(argv[1]) : 1.0;
+    const unsigned maxThreads = argc > 2 ? std::atoi(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    const YachtPhysicsPreset &preset = yachtPresets.at("dn-duvel");
+
+    PhysicsEnvironment env;
+    env.controlledBody = 0;
+
+    std::printf("%10s %8s %14s %18s %14s\n", "yachts", "threads", "ticks/s", "yacht-steps/s", "ns/yacht-step");
+
+    for (int yachtCount : yachtCounts)
+    {
+        PhysicsWorld world;
+
+        // Spread yachts on a grid with varying headings
+        for (int n = 0; n < yachtCount; n++)
+        {
+            PhysicsBodyDesc desc;
+            desc.types = {PhysicsType::Body, PhysicsType::Driving, PhysicsType::Sail};
+            desc.preset = &preset;
+            desc.transform = glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3((n % 100) * 10.0f, (n / 100) * 10.0f, 0.0f)),
+                                         n * 0.7f, glm::vec3(0.0f, 0.0f, 1.0f));
+            world.addBody(desc);
+        }
+
+        for (unsigned threads : threadCounts)
+        {
+            WorkerPool pool(threads);
+
+            // Warm up
+            for (int i = 0; i < 30; i++)
+            {
+                world.beginTicks();
+                world.step(env, pool);
+                world.publish();
+            }
+
+            long long ticks = 0;
+            double elapsed = 0.0;
+            auto start = std::chrono::steady_clock::now();
+
+            while (elapsed < minSeconds)
+            {
+                for (int i = 0; i < 16; i++)
+                {
+                    world.beginTicks();
+                    world.step(env, pool);
+                    world.publish();
+                }
+                ticks += 16;
+                elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+
+            double ticksPerSecond = ticks / elapsed;
+            double yachtSteps = ticksPerSecond * yachtCount;
+            std::printf("%10d %8u %14.0f %18.0f %14.1f\n", yachtCount, threads, ticksPerSecond, yachtSteps, 1e9 / yachtSteps);
+        }
+    }
+
+    return 0;
+}
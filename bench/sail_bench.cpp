@@ -0,0 +1,187 @@
+#include "physics/physics_world.hpp"
+#include "physics/wind_field.hpp"
+
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/vector_angle.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Sail state of a batch of yachts, all with the same preset
+struct SailBatch
+{
+    std::vector<glm::quat> rot;
+    std::vector<glm::vec3> vel;
+    std::vector<float> boomAngle;
+    std::vector<glm::vec3> netForce;
+};
+
+// Coefficients as they were, branches for CL and pow for CD
+static void coefficientsBefore(float angleAttack, const YachtPhysicsPreset::SailPreset &preset, float &CL, float &CD)
+{
+    const float maxLiftCoefficient = preset.maxLiftCoefficient;
+    const float optimalAngle = glm::radians(preset.optimalAngle);
+
+    if (fabs(angleAttack) <= optimalAngle)
+        CL = maxLiftCoefficient * (angleAttack / optimalAngle);
+    else if (fabs(angleAttack) < glm::half_pi<float>())
+        CL = maxLiftCoefficient * (optimalAngle / fabs(angleAttack)) * (angleAttack > 0 ? 1.0f : -1.0f);
+    else
+        CL = 0.0f;
+
+    CD = preset.minDragCoefficient + pow(sin(angleAttack), 2);
+}
+
+// Sail step as it was, mat4 rotation and the coefficients above, kept as the reference
+static void sailBefore(SailBatch &batch, const YachtPhysicsPreset::SailPreset &preset, const glm::vec3 &windDirection, float windStrength)
+{
+    for (size_t i = 0; i < batch.rot.size(); i++)
+    {
+        glm::vec3 heading = batch.rot[i] * glm::vec3(0, 1, 0);
+        float angleToWind = glm::orientedAngle(heading, -windDirection, glm::vec3(0.0f, 0.0f, 1.0f));
+        float sailAngle = batch.boomAngle[i] * (1 + 0.1 * fabs(sin(angleToWind / 2)));
+
+        glm::vec3 apparentWind = windDirection * windStrength - batch.vel[i];
+        glm::vec3 apparentWindDirection = glm::normalize(apparentWind);
+        float apparentWindSpeed = glm::length(apparentWind);
+
+        glm::mat4 rot = glm::rotate(glm::mat4(1.0f), sailAngle, glm::vec3(0.0f, 0.0f, 1.0f));
+        glm::vec3 sailDir = glm::vec3(rot * glm::vec4(heading, 0.0f));
+
+        float angleAttack = glm::orientedAngle(-apparentWindDirection, sailDir, glm::vec3(0.0f, 0.0f, 1.0f));
+
+        float CL, CD;
+        coefficientsBefore(angleAttack, preset, CL, CD);
+
+        float dynamicPressure = 0.5f * 1.225f * apparentWindSpeed * apparentWindSpeed;
+        glm::vec3 dragHorizontal = glm::normalize(glm::vec3(apparentWindDirection.x, apparentWindDirection.y, 0.0f));
+        glm::vec3 liftDir = glm::vec3(dragHorizontal.y, -dragHorizontal.x, 0.0f);
+
+        batch.netForce[i] = dynamicPressure * preset.sailArea * (CL * liftDir + CD * apparentWindDirection);
+    }
+}
+
+// Yachts on a grid with random headings, with or without a sail
+static void fillWorld(PhysicsWorld &world, const YachtPhysicsPreset &preset, int yachtCount, bool sails)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> angle(-glm::pi<float>(), glm::pi<float>());
+
+    for (int n = 0; n < yachtCount; n++)
+    {
+        PhysicsBodyDesc desc;
+        desc.types = {PhysicsType::Body, PhysicsType::Driving};
+        if (sails)
+            desc.types.push_back(PhysicsType::Sail);
+        desc.preset = &preset;
+        desc.transform = glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3((n % 100) * 10.0f, (n / 100) * 10.0f, 0.0f)),
+                                     angle(rng), glm::vec3(0.0f, 0.0f, 1.0f));
+        world.addBody(desc);
+    }
+}
+
+// Seconds per tick of the whole world, on the calling thread
+static double timeTicks(PhysicsWorld &world, const PhysicsEnvironment &env, int repeats)
+{
+    // Warm up, the yachts get moving
+    for (int i = 0; i < 30; i++)
+    {
+        world.beginTicks();
+        world.step(env);
+        world.publish();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+    {
+        world.beginTicks();
+        world.step(env);
+        world.publish();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / repeats;
+}
+
+// Times the per yacht sail step before tabulating the coefficients against PhysicsWorld as it is now
+// After is the tick of yachts with sails minus the same yachts without, so it covers wind sampling and updateSails
+int main()
+{
+    const YachtPhysicsPreset &preset = yachtPresets.at("dn-duvel");
+    const glm::vec3 windDirection(0.0f, 1.0f, 0.0f);
+    const float windStrength = 10.0f;
+    const int repeats = 200;
+
+    std::printf("%8s %14s %14s\n", "yachts", "ns/yacht before", "ns/yacht after");
+
+    for (int yachtCount : {100, 1000, 10000})
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> angle(-glm::pi<float>(), glm::pi<float>());
+        std::uniform_real_distribution<float> speed(-15.0f, 15.0f);
+        std::uniform_real_distribution<float> boom(-1.2f, 1.2f);
+
+        SailBatch before;
+        for (int i = 0; i < yachtCount; i++)
+        {
+            before.rot.push_back(glm::angleAxis(angle(rng), glm::vec3(0, 0, 1)));
+            before.vel.push_back(glm::vec3(speed(rng), speed(rng), 0.0f));
+            before.boomAngle.push_back(boom(rng));
+        }
+        before.netForce.resize(yachtCount);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; r++)
+            sailBefore(before, preset.sail, windDirection, windStrength);
+        double beforeNs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1e9 / (repeats * yachtCount);
+
+        // Gusty wind over the fleet, sampled per sail like the scenes do
+        PhysicsEnvironment env;
+        env.windDirection = windDirection;
+        env.windStrength = windStrength;
+
+        WindField windField;
+        windField.generate(128, 8.0f, glm::vec2(500.0f, 5.0f * (yachtCount / 100)), windDirection, windStrength);
+        env.windField = &windField;
+
+        PhysicsWorld sailWorld, bareWorld;
+        fillWorld(sailWorld, preset, yachtCount, true);
+        fillWorld(bareWorld, preset, yachtCount, false);
+
+        double sailSeconds = timeTicks(sailWorld, env, repeats);
+        double bareSeconds = timeTicks(bareWorld, env, repeats);
+        double afterNs = (sailSeconds - bareSeconds) * 1e9 / yachtCount;
+
+        std::printf("%8d %14.1f %14.1f\n", yachtCount, beforeNs, afterNs);
+    }
+
+    // Table interpolation error, against the coefficients above over the full range of attack angles
+    PhysicsWorld world;
+    fillWorld(world, preset, 1, true);
+    const SailCoefficientTable &table = world.sailProperties.tables[world.sailProperties.table[0]];
+
+    float maxLiftDiff = 0.0f, maxDragDiff = 0.0f;
+    const int samples = 100000;
+    for (int n = 0; n <= samples; n++)
+    {
+        float angleAttack = -glm::pi<float>() + 2.0f * glm::pi<float>() * n / samples;
+
+        // Lift steps to zero at 90 degrees, a sample rounding across the step says nothing about the table
+        if (std::fabs(std::fabs(angleAttack) - glm::half_pi<float>()) < 1e-4f)
+            continue;
+
+        float liftBefore, dragBefore, lift, drag;
+        coefficientsBefore(angleAttack, preset.sail, liftBefore, dragBefore);
+        table.lookup(angleAttack, lift, drag);
+
+        maxLiftDiff = std::max(maxLiftDiff, std::fabs(lift - liftBefore));
+        maxDragDiff = std::max(maxDragDiff, std::fabs(drag - dragBefore));
+    }
+
+    std::printf("max CL diff %.4f of %.2f, max CD diff %.4f\n", maxLiftDiff, preset.sail.maxLiftCoefficient, maxDragDiff);
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "render/stream_buffer.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Copies every slice of a frame out on the GPU and reads it back, counts the bytes that differ from what was uploaded
+static size_t countMismatches(const std::vector<StreamSlice> &slices, const std::vector<unsigned char> &data, size_t sliceSize, unsigned int checkBuffer)
+{
+    std::vector<unsigned char> readBack(sliceSize);
+    size_t mismatches = 0;
+
+    for (size_t s = 0; s < slices.size(); s++)
+    {
+        glBindBuffer(GL_COPY_READ_BUFFER, slices[s].buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, checkBuffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, slices[s].offset, 0, sliceSize);
+        glGetBufferSubData(GL_COPY_WRITE_BUFFER, 0, sliceSize, readBack.data());
+
+        for (size_t i = 0; i < sliceSize; i++)
+            mismatches += readBack[i] != data[s * sliceSize + i];
+    }
+
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return mismatches;
+}
+
+// Times per frame uploads through StreamBuffer, and checks that the GPU reads back what every slice was given
+// The driver decides the path, on Mesa MESA_EXTENSION_OVERRIDE=-GL_ARB_buffer_storage forces orphaning
+int main()
+{
+    if (!glfwInit())
+    {
+        std::printf("Failed to initialize GLFW\n");
+        return 1;
+    }
+
+    // Same context as the app, without showing the window
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+
+    GLFWwindow *window = glfwCreateWindow(64, 64, "StreamBufferBench", nullptr, nullptr);
+    if (!window)
+    {
+        std::printf("Failed to create GLFW window\n");
+        glfwTerminate();
+        return 1;
+    }
+    glfwMakeContextCurrent(window);
+
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::printf("Failed to initialize GLAD\n");
+        return 1;
+    }
+
+    const int frames = 300;
+    const int slicesPerFrame = 8;
+    const int checkEvery = 16;
+
+    // Starts small, so the larger uploads grow the ring in their first frame
+    StreamBuffer stream;
+    stream.init(64 << 10);
+
+    unsigned int checkBuffer;
+    glGenBuffers(1, &checkBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, checkBuffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, 1 << 20, nullptr, GL_STREAM_READ);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    std::printf("%s | %s\n", glGetString(GL_RENDERER), glGetString(GL_VERSION));
+    std::printf("%s path\n", stream.persistent() ? "persistent" : "orphaning");
+    std::printf("%10s %12s %10s %8s %8s %12s\n", "KB/frame", "us/frame", "MB/s", "waits", "grows", "mismatches");
+
+    std::mt19937 rng(42);
+
+    for (size_t frameBytes : {16 << 10, 256 << 10, 4 << 20})
+    {
+        size_t sliceSize = frameBytes / slicesPerFrame;
+        std::vector<unsigned char> data(frameBytes);
+        std::vector<StreamSlice> slices(slicesPerFrame);
+
+        int waitsBefore = StreamBuffer::waits, growsBefore = StreamBuffer::grows;
+        size_t mismatches = 0;
+        double seconds = 0.0;
+
+        for (int f = 0; f < frames; f++)
+        {
+            // Fresh bytes every frame, so a region read before its fence shows up as a mismatch
+            for (unsigned char &byte : data)
+                byte = static_cast<unsigned char>(rng());
+
+            auto start = std::chrono::steady_clock::now();
+            for (int s = 0; s < slicesPerFrame; s++)
+                slices[s] = stream.upload(data.data() + s * sliceSize, sliceSize, 256);
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            if (f % checkEvery == 0 || f == frames - 1)
+                mismatches += countMismatches(slices, data, sliceSize, checkBuffer);
+
+            start = std::chrono::steady_clock::now();
+            stream.endFrame();
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            glfwSwapBuffers(window);
+        }
+
+        std::printf("%10zu %12.1f %10.0f %8d %8d %12zu\n", frameBytes >> 10, seconds * 1e6 / frames, frameBytes * frames / seconds / (1 << 20),
+                    StreamBuffer::waits - waitsBefore, StreamBuffer::grows - growsBefore, mismatches);
+    }
+
+    std::printf("GL error 0x%x\n", glGetError());
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
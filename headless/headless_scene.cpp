@@ -0,0 +1,236 @@
+#include "headless_scene.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#include <jsoncons/json.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "model/model_defs.h"
+#include "physics/physics_world.hpp"
+
+// Subset of the scene json that physics needs
+struct HeadlessJSONModel
+{
+    std::string name = "none";
+    std::vector<float> scale = {1, 1, 1};
+    float angle = 0;
+    std::vector<float> rotationAxis = {0, 1, 0};
+    std::vector<float> translation = {0, 0, 0};
+    std::vector<std::string> physics;
+    bool controlled = false;
+};
+
+struct HeadlessJSONScene
+{
+    std::vector<HeadlessJSONModel> models;
+};
+
+// Json mappings, same as the game uses
+JSONCONS_N_MEMBER_TRAITS(HeadlessJSONModel, 1, name, scale, angle, rotationAxis, translation, physics, controlled);
+JSONCONS_N_MEMBER_TRAITS(HeadlessJSONScene, 0, models);
+JSONCONS_N_MEMBER_TRAITS(JSONModelMapEntry, 1, mainPath, lodPaths, type);
+JSONCONS_N_MEMBER_TRAITS(JSONModelMap, 0, models, yachts);
+
+namespace
+{
+    std::ifstream openFile(const std::string &path)
+    {
+        // Check if the file exists
+        if (!std::filesystem::exists(path))
+        {
+            throw std::runtime_error("File not found: " + path);
+        }
+
+        // Open the file
+        std::ifstream file(path);
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Could not open file: " + path);
+        }
+
+        return file;
+    }
+
+    // Mesh positions of every non armature node, like Model::processNode, one list per mesh
+    void collectPoints(aiNode *node, const aiScene *scene, std::vector<std::vector<glm::vec3>> &meshPoints)
+    {
+        std::string nodeName = node->mName.C_Str();
+
+        if (nodeName.rfind("Armature", 0) != 0)
+        {
+            for (unsigned int i = 0; i < node->mNumMeshes; i++)
+            {
+                aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
+                auto &points = meshPoints.emplace_back();
+                for (unsigned int v = 0; v < mesh->mNumVertices; v++)
+                    points.push_back(glm::vec3(mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z));
+            }
+        }
+
+        for (unsigned int i = 0; i < node->mNumChildren; i++)
+            collectPoints(node->mChildren[i], scene, meshPoints);
+    }
+
+    // Hitbox falls back to the lowest LOD, like Model::loadHitbox
+    // A hitbox file gets one hull per mesh, the LOD fallback one hull over all its meshes
+    std::shared_ptr<const std::vector<ConvexHull>> loadHitboxHulls(const JSONModelMapEntry &entry)
+    {
+        std::string path = entry.hitboxPath;
+        if (path.empty())
+            path = entry.lodPaths.empty() ? entry.mainPath : entry.lodPaths.back();
+
+        auto hulls = std::make_shared<std::vector<ConvexHull>>();
+
+        Assimp::Importer importer;
+        const aiScene *scene = importer.ReadFile(path, aiProcess_Triangulate);
+
+        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+        {
+            std::cout << "Assimp Error (" << path << "): " << importer.GetErrorString() << std::endl;
+            return hulls;
+        }
+
+        std::vector<std::vector<glm::vec3>> meshPoints;
+        collectPoints(scene->mRootNode, scene, meshPoints);
+
+        if (entry.hitboxPath.empty())
+        {
+            std::vector<glm::vec3> points;
+            for (const auto &mesh : meshPoints)
+                points.insert(points.end(), mesh.begin(), mesh.end());
+            hulls->push_back(ConvexHull::build(points));
+        }
+        else
+        {
+            for (const auto &mesh : meshPoints)
+                hulls->push_back(ConvexHull::build(mesh));
+        }
+
+        return hulls;
+    }
+}
+
+int HeadlessScene::load(PhysicsWorld &world, const std::string &sceneName, int yachtCount)
+{
+    // Scene map
+    std::ifstream sceneMapFile = openFile(sceneMapPath);
+    jsoncons::json sceneMap = jsoncons::json::parse(sceneMapFile);
+
+    if (!sceneMap["scenes"].contains(sceneName))
+        throw std::runtime_error("Scene not found: " + sceneName);
+
+    // Model map
+    std::ifstream modelMapFile = openFile(modelMapPath);
+    JSONModelMap jsonModelMap = jsoncons::decode_json<JSONModelMap>(modelMapFile);
+
+    std::map<std::string, JSONModelMapEntry> modelMap;
+    for (const auto &[name, data] : jsonModelMap.yachts)
+        modelMap[name] = data;
+    for (const auto &[name, data] : jsonModelMap.models)
+        modelMap[name] = data;
+
+    // Scene
+    std::ifstream sceneFile = openFile(sceneMap["scenes"][sceneName].as<std::string>());
+    HeadlessJSONScene jsonScene = jsoncons::decode_json<HeadlessJSONScene>(sceneFile);
+
+    std::vector<PhysicsBodyDesc> yachts;
+    std::vector<bool> yachtControlled;
+    std::map<std::string, std::shared_ptr<const std::vector<ConvexHull>>> hitboxCache;
+    int controlledBody = -1;
+
+    for (const HeadlessJSONModel &model : jsonScene.models)
+    {
+        if (model.physics.empty())
+            continue;
+
+        auto entry = modelMap.find(model.name);
+        if (entry == modelMap.end())
+        {
+            std::cerr << "Model not found in model map: " << model.name << std::endl;
+            continue;
+        }
+
+        PhysicsBodyDesc desc;
+
+        for (const auto &type : model.physics)
+        {
+            if (type == "body")
+                desc.types.push_back(PhysicsType::Body);
+            if (type == "driving")
+                desc.types.push_back(PhysicsType::Driving);
+            if (type == "sail")
+                desc.types.push_back(PhysicsType::Sail);
+            if (type == "gravity")
+                desc.types.push_back(PhysicsType::Gravity);
+            if (type == "collision")
+                desc.types.push_back(PhysicsType::Collision);
+        }
+
+        desc.transform = glm::scale(
+            glm::rotate(
+                glm::translate(glm::mat4(1.0f), glm::vec3(model.translation[0], model.translation[1], model.translation[2])),
+                glm::radians(model.angle),
+                glm::vec3(model.rotationAxis[0], model.rotationAxis[1], model.rotationAxis[2])),
+            glm::vec3(model.scale[0], model.scale[1], model.scale[2]));
+
+        if (std::find(desc.types.begin(), desc.types.end(), PhysicsType::Collision) != desc.types.end())
+        {
+            if (hitboxCache.find(model.name) == hitboxCache.end())
+                hitboxCache[model.name] = loadHitboxHulls(entry->second);
+            desc.hitboxHulls = hitboxCache[model.name];
+        }
+
+        if (entry->second.type == "yacht")
+        {
+            auto preset = yachtPresets.find(model.name);
+            if (preset != yachtPresets.end())
+                desc.preset = &preset->second;
+            else
+                std::cerr << "Yacht physics properties not found for: " << model.name << std::endl;
+
+            yachts.push_back(desc);
+            yachtControlled.push_back(model.controlled);
+            continue;
+        }
+
+        // Other bodies are added once
+        int index = world.addBody(desc);
+        if (model.controlled)
+            controlledBody = index;
+    }
+
+    if (yachts.empty())
+        return controlledBody;
+
+    if (yachtCount <= 0)
+        yachtCount = static_cast<int>(yachts.size());
+
+    // Repeat the scene's yachts, each repeat offset on a grid
+    const float spacing = 25.0f;
+    for (int n = 0; n < yachtCount; n++)
+    {
+        int source = n % yachts.size();
+        int copy = n / yachts.size();
+
+        PhysicsBodyDesc desc = yachts[source];
+        desc.transform[3] += glm::vec4((copy % 64) * spacing, (copy / 64) * spacing, 0.0f, 0.0f);
+
+        int index = world.addBody(desc);
+        if (copy == 0 && yachtControlled[source])
+            controlledBody = index;
+    }
+
+    return controlledBody;
+}
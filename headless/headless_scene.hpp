@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+
+class PhysicsWorld;
+
+// Physics relevant parts of a scene, loaded without a window or GL context
+namespace HeadlessScene
+{
+    inline std::string sceneMapPath = "resources/scenes.json";
+    inline std::string modelMapPath = "resources/models.json";
+
+    // Fill world with the bodies of a scene, yachts are repeated on a grid until yachtCount is reached
+    // Returns the index of the controlled body, or -1
+    int load(PhysicsWorld &world, const std::string &sceneName, int yachtCount);
+};
@@ -0,0 +1,178 @@
+#include "headless_scene.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "physics/physics_world.hpp"
+#include "physics/wind_field.hpp"
+#include "thread_manager/worker_pool.hpp"
+
+// Count every allocation in the process
+static std::atomic<long long> allocationCount{0};
+
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void *operator new[](std::size_t size) { return operator new(size); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+struct HeadlessOptions
+{
+    std::string scene = "test-yacht";
+    int yachts = 0;
+    int ticks = 1000;
+    int threads = 1;
+    float tickRate = 30.0f;
+    int windField = 0;
+
+    // Regression gates, ignored when negative
+    double maxNsPerStep = -1.0;
+    double maxAllocationsPerTick = -1.0;
+};
+
+static void printUsage()
+{
+    std::cout << "Usage: MaramaHeadless [--scene name] [--yachts N] [--ticks M] [--threads T] [--tick-rate hz] [--wind-field cells]\n"
+              << "                      [--max-ns-per-step ns] [--max-allocs-per-tick n]\n"
+              << "Run from the repository root so resources/ can be found." << std::endl;
+}
+
+static bool parseOptions(int argc, char **argv, HeadlessOptions &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc)
+            return false;
+
+        std::string value = argv[++i];
+        if (arg == "--scene")
+            options.scene = value;
+        else if (arg == "--yachts")
+            options.yachts = std::atoi(value.c_str());
+        else if (arg == "--ticks")
+            options.ticks = std::atoi(value.c_str());
+        else if (arg == "--threads")
+            options.threads = std::atoi(value.c_str());
+        else if (arg == "--tick-rate")
+            options.tickRate = static_cast<float>(std::atof(value.c_str()));
+        else if (arg == "--wind-field")
+            options.windField = std::atoi(value.c_str());
+        else if (arg == "--max-ns-per-step")
+            options.maxNsPerStep = std::atof(value.c_str());
+        else if (arg == "--max-allocs-per-tick")
+            options.maxAllocationsPerTick = std::atof(value.c_str());
+        else
+            return false;
+    }
+    return options.ticks > 0 && options.threads > 0 && options.tickRate > 0.0f;
+}
+
+// Steps a scene's physics without a window and reports throughput
+int main(int argc, char **argv)
+{
+    HeadlessOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage();
+        return 2;
+    }
+
+    PhysicsWorld world;
+    PhysicsEnvironment env;
+    env.tickTime = 1.0f / options.tickRate;
+
+    try
+    {
+        env.controlledBody = HeadlessScene::load(world, options.scene, options.yachts);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+
+    const size_t bodies = world.bodyCount();
+    if (bodies == 0)
+    {
+        std::cerr << "Scene has no physics bodies: " << options.scene << std::endl;
+        return 2;
+    }
+
+    // Wind field over the bodies, like PhysicsUtil::setup, 0 keeps the wind uniform
+    WindField windField;
+    if (options.windField > 0)
+    {
+        glm::vec2 center(0.0f);
+        for (const auto &pos : world.getWriteState().base.pos)
+            center += glm::vec2(pos);
+        center /= static_cast<float>(bodies);
+
+        windField.generate(options.windField, 2.0f, center, env.windDirection, env.windStrength);
+        env.windField = &windField;
+    }
+
+    WorkerPool pool(options.threads);
+
+    // Warm up, lets the first ticks settle before measuring
+    for (int i = 0; i < 10; i++)
+    {
+        world.beginTicks();
+        world.step(env, pool);
+        world.publish();
+    }
+
+    long long allocationsBefore = allocationCount.load();
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < options.ticks; i++)
+    {
+        world.beginTicks();
+        world.step(env, pool);
+        world.publish();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long long allocations = allocationCount.load() - allocationsBefore;
+
+    double ticksPerSecond = options.ticks / seconds;
+    double nsPerStep = seconds * 1e9 / (static_cast<double>(options.ticks) * bodies);
+    double allocationsPerTick = static_cast<double>(allocations) / options.ticks;
+
+    std::printf("scene: %s\n", options.scene.c_str());
+    std::printf("bodies: %zu\n", bodies);
+    std::printf("threads: %u\n", pool.size());
+    std::printf("ticks: %d\n", options.ticks);
+    std::printf("seconds: %.4f\n", seconds);
+    std::printf("ticks/s: %.1f\n", ticksPerSecond);
+    std::printf("ns/yacht-step: %.1f\n", nsPerStep);
+    std::printf("allocations/tick: %.3f\n", allocationsPerTick);
+
+    // Regression gates
+    int result = 0;
+    if (options.maxNsPerStep >= 0.0 && nsPerStep > options.maxNsPerStep)
+    {
+        std::fprintf(stderr, "FAIL: %.1f ns/yacht-step exceeds %.1f\n", nsPerStep, options.maxNsPerStep);
+        result = 1;
+    }
+    if (options.maxAllocationsPerTick >= 0.0 && allocationsPerTick > options.maxAllocationsPerTick)
+    {
+        std::fprintf(stderr, "FAIL: %.3f allocations/tick exceeds %.3f\n", allocationsPerTick, options.maxAllocationsPerTick);
+        result = 1;
+    }
+
+    return result;
+}
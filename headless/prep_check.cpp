@@ -0,0 +1,193 @@
+#include "pch.h"
+
+#include <cstdio>
+
+// Render prep of a race built in code, without a window, GL context or model files
+// Prep only reads meshes, bones and the camera, GL is touched by uploadToGPU and executeRender, neither runs here
+
+namespace
+{
+    // Box of the given size around the origin, enough for bounds, culling and sorting
+    template <typename VertexType>
+    MeshVariant boxMesh(glm::vec3 size, shaderID shader)
+    {
+        std::vector<VertexType> vertices(8);
+        for (int corner = 0; corner < 8; corner++)
+            vertices[corner].Position = 0.5f * size * glm::vec3(corner & 1 ? 1.0f : -1.0f, corner & 2 ? 1.0f : -1.0f, corner & 4 ? 1.0f : -1.0f);
+
+        Mesh<VertexType> mesh(vertices, {0, 1, 2, 1, 3, 2}, shader);
+        mesh.bounds = MeshUtil::computeBounds(mesh.vertices);
+        mesh.VAO = mesh.VBO = mesh.EBO = 0;
+        return mesh;
+    }
+
+    // Nothing is uploaded, so every vertex array is 0
+    void clearHandles(MeshVariant &mesh)
+    {
+        std::visit([](auto &actualMesh)
+                   { actualMesh.VAO = actualMesh.VBO = actualMesh.EBO = 0; },
+                   mesh);
+    }
+
+    ModelData placeModel(Model &model, const glm::mat4 &u_model, shaderID shader, bool animated)
+    {
+        ModelData data;
+        data.model = &model;
+        data.u_model = u_model;
+        data.u_normal = glm::transpose(glm::inverse(u_model));
+        data.shader = shader;
+        data.color = glm::vec3(1.0f);
+        data.animated = animated;
+        data.controlled = false;
+
+        if (animated)
+        {
+            data.bonePalette = std::make_unique<BonePalette>();
+            data.bonePalette->resize(model.boneInverseOffsets.size());
+        }
+        return data;
+    }
+
+    // Yachts on a ring around the controlled one, props scattered further out, water, ground and a grid
+    void buildScene(Scene &scene, int yachtCount, int propCount)
+    {
+        Model &yacht = scene.loadedModels["check-yacht"];
+        yacht.name = "check-yacht";
+        yacht.modelType = ModelType::Yacht;
+        yacht.texturePaths = {"hull.png", "deck.png", "sail.png"};
+        for (int lod = 0; lod < 3; lod++)
+            yacht.lodMeshes.push_back({boxMesh<VertexAnimated>(glm::vec3(2.0f, 4.2f, 1.5f), shaderID::Toon),
+                                       boxMesh<VertexAnimated>(glm::vec3(0.2f, 3.0f, 8.0f), shaderID::Toon)});
+        yacht.boneInverseOffsets.assign(12, glm::mat4(1.0f));
+        yacht.yachtBones.cam = 11;
+
+        Model &prop = scene.loadedModels["check-prop"];
+        prop.name = "check-prop";
+        prop.modelType = ModelType::Model;
+        prop.texturePaths = {"prop.png"};
+        for (int lod = 0; lod < 2; lod++)
+            prop.lodMeshes.push_back({boxMesh<VertexTextured>(glm::vec3(3.0f, 3.0f, 6.0f), shaderID::Default)});
+
+        scene.structModels.push_back(placeModel(yacht, glm::mat4(1.0f), shaderID::Toon, true));
+        scene.structModels.back().controlled = true;
+
+        for (int i = 0; i < yachtCount; i++)
+        {
+            float angle = glm::two_pi<float>() * i / yachtCount;
+            glm::mat4 u_model = glm::rotate(glm::translate(glm::mat4(1.0f), 40.0f * glm::vec3(std::cos(angle), std::sin(angle), 0.0f)), angle, glm::vec3(0, 0, 1));
+            scene.structModels.push_back(placeModel(yacht, u_model, shaderID::Toon, true));
+        }
+
+        for (int i = 0; i < propCount; i++)
+        {
+            float angle = 2.39996f * i;
+            float distance = 20.0f + 4.0f * i;
+            glm::mat4 u_model = glm::translate(glm::mat4(1.0f), distance * glm::vec3(std::cos(angle), std::sin(angle), 0.0f));
+            scene.structModels.push_back(placeModel(prop, u_model, shaderID::Default, false));
+        }
+
+        glm::mat4 ground = glm::scale(glm::mat4(1.0f), glm::vec3(500.0f, 500.0f, 1.0f));
+
+        UnitPlaneData sand;
+        sand.color = glm::vec3(0.8f, 0.7f, 0.5f);
+        sand.shader = shaderID::Terrain;
+        sand.unitPlane = MeshUtil::genUnitPlane<VertexTextured>(sand.color, sand.shader);
+        sand.u_model = ground;
+        sand.u_normal = glm::transpose(glm::inverse(ground));
+        sand.position = ground[3];
+        clearHandles(sand.unitPlane);
+        scene.opaqueUnitPlanes.push_back(sand);
+
+        UnitPlaneData water = sand;
+        water.shader = shaderID::Water;
+        water.unitPlane = MeshUtil::genUnitPlane<VertexTextured>(water.color, water.shader);
+        water.u_model = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.25f)) * ground;
+        water.position = water.u_model[3];
+        clearHandles(water.unitPlane);
+        scene.transparentUnitPlanes.push_back(water);
+        ShaderUtil::waterLoaded = true;
+
+        GridData grid{glm::vec3(0.3f, 0.6f, 0.3f), glm::mat4(1.0f), glm::mat3(1.0f), shaderID::ToonTerrain, glm::vec2(64.0f, 64.0f), 0.0f};
+        clearHandles(grid.grid);
+        scene.grids.push_back(std::move(grid));
+    }
+}
+
+// Prepares a turning race frame after frame on all three buffers, like the prep thread does
+// Fails when a frame after the warm-up allocates, once every buffer has seen every view nothing should need to grow
+int main()
+{
+    const int yachtCount = 24;
+    const int propCount = 60;
+    const int degreesPerFrame = 3;
+    const int warmupFrames = 2 * 360 / degreesPerFrame;
+    const int checkedFrames = 3 * 360 / degreesPerFrame;
+
+    WindowManager::screenWidth = 1920;
+    WindowManager::screenHeight = 1080;
+    SceneManager::engineState = EngineState::Running;
+    ThreadManager::jobSystem = std::make_unique<JobSystem>(std::max(2u, std::thread::hardware_concurrency()));
+
+    // Never destroyed, models release their GL objects on destruction and there is no context
+    Scene *scene = new Scene();
+    buildScene(*scene, yachtCount, propCount);
+    SceneManager::currentScene = std::shared_ptr<Scene>(scene, [](Scene *) {});
+
+    long long warmupAllocations = 0, checkedAllocations = 0, worstFrame = 0;
+    size_t commands[renderPassCount] = {};
+
+    for (int frame = 0; frame < warmupFrames + checkedFrames; frame++)
+    {
+        // The controlled yacht turns in place, so the views sweep over everything around it
+        float heading = glm::radians(static_cast<float>(degreesPerFrame * frame));
+        for (size_t i = 0; i < scene->structModels.size(); i++)
+        {
+            ModelData &model = scene->structModels[i];
+            if (model.controlled)
+            {
+                model.u_model = glm::rotate(glm::mat4(1.0f), heading, glm::vec3(0, 0, 1));
+                model.u_normal = glm::transpose(glm::inverse(model.u_model));
+            }
+
+            // A fresh pose every frame, as the animation thread publishes it
+            if (model.animated)
+            {
+                std::vector<glm::mat4> &bones = model.bonePalette->write();
+                for (size_t b = 0; b < bones.size(); b++)
+                    bones[b] = glm::rotate(glm::mat4(1.0f), 0.01f * frame + 0.1f * b, glm::vec3(0, 0, 1));
+                model.bonePalette->publish();
+            }
+        }
+
+        ::RenderBuffer &buffer = Render::renderBuffers[frame % Render::renderBuffers.size()];
+
+        long long before = AllocationCounter::counted();
+        Render::prepareRender(buffer);
+        long long allocations = AllocationCounter::counted() - before;
+
+        if (frame < warmupFrames)
+            warmupAllocations += allocations;
+        else
+        {
+            checkedAllocations += allocations;
+            worstFrame = std::max(worstFrame, allocations);
+            for (int pass = 0; pass < renderPassCount; pass++)
+                commands[pass] = std::max(commands[pass], buffer.commandBuffers[pass].size());
+        }
+    }
+
+    std::printf("items: %zu models, %zu planes, %zu grids\n", scene->structModels.size(),
+                scene->opaqueUnitPlanes.size() + scene->transparentUnitPlanes.size(), scene->grids.size());
+    std::printf("threads: %u\n", ThreadManager::jobSystem->size());
+    std::printf("most commands main/reflect/refract: %zu/%zu/%zu\n", commands[0], commands[1], commands[2]);
+    std::printf("warm-up frames: %d, allocations: %lld\n", warmupFrames, warmupAllocations);
+    std::printf("checked frames: %d, allocations: %lld, worst frame: %lld\n", checkedFrames, checkedAllocations, worstFrame);
+
+    if (checkedAllocations > 0)
+    {
+        std::fprintf(stderr, "FAIL: render prep allocated %lld times after the warm-up\n", checkedAllocations);
+        return 1;
+    }
+
+    return 0;
+}
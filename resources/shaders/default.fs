@@ -11,8 +11,18 @@ in VS_OUT
 }
 fs_in;
 
-uniform vec3 lightCol;
-uniform float lightIntensity;
+// Per view data, shared by every program
+layout(std140) uniform FrameData
+{
+    mat4 u_view;
+    mat4 u_projection;
+    mat4 u_camXY;
+    vec4 location_plane;
+    vec3 viewPos;
+    float lightIntensity;
+    vec3 lightPos;
+    vec3 lightCol;
+};
 
 uniform int textureLayers[2];
 uniform sampler2DArray textureArray;
@@ -2,7 +2,7 @@
 
 // Input vertex attributes
 layout(location = 0) in vec3 position;  // Vertex position in local space (model space)
-layout(location = 1) in vec3 normal;
+layout(location = 1) in vec2 normal;  // Octahedral, unused
 layout(location = 2) in vec3 color;     // Vertex color
 
 // Output to fragment shader
@@ -10,8 +10,19 @@ out vec3 vertexColor;
 
 // Uniforms for transformation matrices
 uniform mat4 u_model;           // Model Matrix: transforms from local to world space
-uniform mat4 u_view;            // View Matrix: transforms from world space to camera/view space
-uniform mat4 u_projection;      // Projection matrix: transforms from camera space to clip space
+
+// Per view data, shared by every program
+layout(std140) uniform FrameData
+{
+    mat4 u_view;
+    mat4 u_projection;
+    mat4 u_camXY;
+    vec4 location_plane;
+    vec3 viewPos;
+    float lightIntensity;
+    vec3 lightPos;
+    vec3 lightCol;
+};
 
 void main()
 {
@@ -3,8 +3,19 @@
 layout(location = 0) in vec3 position;
 
 uniform mat4 u_model;
-uniform mat4 u_view;
-uniform mat4 u_projection;
+
+// Per view data, shared by every program
+layout(std140) uniform FrameData
+{
+    mat4 u_view;
+    mat4 u_projection;
+    mat4 u_camXY;
+    vec4 location_plane;
+    vec3 viewPos;
+    float lightIntensity;
+    vec3 lightPos;
+    vec3 lightCol;
+};
 
 void main()
 {
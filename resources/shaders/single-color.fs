@@ -4,10 +4,20 @@ out vec4 FragColor;
 
 in vec3 FragPos;
 in vec3 Normal;
+in vec3 BodyColor;
 
-uniform vec3 bodyColor;
-uniform vec3 lightPos;
-uniform vec3 lightCol;
+// Per view data, shared by every program
+layout(std140) uniform FrameData
+{
+    mat4 u_view;
+    mat4 u_projection;
+    mat4 u_camXY;
+    vec4 location_plane;
+    vec3 viewPos;
+    float lightIntensity;
+    vec3 lightPos;
+    vec3 lightCol;
+};
 
 const float ambientStrength = 0.5;
 
@@ -20,6 +30,6 @@ void main()
     float diff = max(dot(norm, lightDir), 0.0);
     vec3 diffuse = (1 - ambientStrength) * diff * lightCol;
 
-    vec3 result = (ambient + diffuse) * bodyColor;
+    vec3 result = (ambient + diffuse) * BodyColor;
     FragColor = vec4(result, 1.0);
 }
\ No newline at end of file
@@ -1,19 +1,45 @@
 #version 410 core
 
 layout(location = 0) in vec3 position;
-layout(location = 1) in vec3 normal;
+layout(location = 1) in vec2 normal; // Octahedral
 layout(location = 2) in vec3 color;
 
-uniform mat4 u_model;
-uniform mat4 u_view;
-uniform mat4 u_projection;
+// Per instance
+layout(location = 5) in mat4 aModel;
+layout(location = 9) in mat4 aNormalMatrix;
+layout(location = 13) in vec3 aInstanceColor;
+layout(location = 14) in int aBoneOffset;
+
+// Per view data, shared by every program
+layout(std140) uniform FrameData
+{
+    mat4 u_view;
+    mat4 u_projection;
+    mat4 u_camXY;
+    vec4 location_plane;
+    vec3 viewPos;
+    float lightIntensity;
+    vec3 lightPos;
+    vec3 lightCol;
+};
 
 out vec3 FragPos;
 out vec3 Normal;
+out vec3 BodyColor;
+
+// Unfold a normal stored on the octahedron, see MeshUtil::pack
+vec3 octDecode(vec2 folded)
+{
+    vec3 normal = vec3(folded, 1.0 - abs(folded.x) - abs(folded.y));
+    if(normal.z < 0.0)
+        normal.xy = (1.0 - abs(normal.yx)) * vec2(normal.x >= 0.0 ? 1.0 : -1.0, normal.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(normal);
+}
 
 void main()
 {
-    FragPos = vec3(u_model * vec4(position, 1.0));
-    Normal = mat3(transpose(inverse(u_model))) * normal;
-    gl_Position = u_projection * u_view * u_model * vec4(position, 1.0);
+    FragPos = vec3(aModel * vec4(position, 1.0));
+    Normal = mat3(transpose(inverse(aModel))) * octDecode(normal);
+    BodyColor = aInstanceColor;
+    gl_Position = u_projection * u_view * aModel * vec4(position, 1.0);
 }
\ No newline at end of file
@@ -3,13 +3,24 @@ layout (location = 0) in vec3 aPos;
 
 out vec3 TexCoords;
 
-uniform mat4 u_projection;
-uniform mat4 u_view;
+// Per view data, shared by every program
+layout(std140) uniform FrameData
+{
+    mat4 u_view;
+    mat4 u_projection;
+    mat4 u_camXY;
+    vec4 location_plane;
+    vec3 viewPos;
+    float lightIntensity;
+    vec3 lightPos;
+    vec3 lightCol;
+};
+
 uniform mat4 u_model;
 
 void main()
 {
     TexCoords = aPos.xzy;
-    vec4 pos = u_projection * u_view * u_model * vec4(aPos, 1.0);
+    vec4 pos = u_projection * mat4(mat3(u_view)) * u_model * vec4(aPos, 1.0);
     gl_Position = pos;
 }  
\ No newline at end of file
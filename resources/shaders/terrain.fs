@@ -6,8 +6,18 @@ in vec2 TexCoord;
 
 uniform sampler2DArray sandTextureArray;
 
-uniform vec3 lightPos;
-uniform vec3 lightCol;
+// Per view data, shared by every program
+layout(std140) uniform FrameData
+{
+    mat4 u_view;
+    mat4 u_projection;
+    mat4 u_camXY;
+    vec4 location_plane;
+    vec3 viewPos;
+    float lightIntensity;
+    vec3 lightPos;
+    vec3 lightCol;
+};
 
 const float texScale = 100;
 
@@ -1,10 +1,9 @@
 #version 420 core
 in vec2 TexCoords;  // Texture coordinates passed from vertex shader
+in vec4 TextColor;  // Color and alpha of the glyph
 out vec4 FragColor;  // Final color of the fragment
 
 uniform sampler2D textTexture;  // The texture to sample
-uniform vec3 textColor;  // Color of the text (to apply tint)
-uniform float textAlpha;
 
 void main()
 {
@@ -16,5 +15,5 @@ void main()
         discard;  // Discard fully transparent fragments
     }
     
-    FragColor = vec4(textColor, textAlpha) * texColor;  // Apply tint to the texture color
+    FragColor = TextColor * texColor;  // Apply tint to the texture color
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #version 420 core
 layout(location = 0) in vec4 vertex;  // Position and texture coordinates
+layout(location = 1) in vec4 color;   // Color and alpha of the glyph
 out vec2 TexCoords;
+out vec4 TextColor;
 
 uniform mat4 projection;
 
@@ -8,4 +10,5 @@ void main()
 {
     gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
     TexCoords = vertex.zw;  // Texture coordinates
+    TextColor = color;
 }
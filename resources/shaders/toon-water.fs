@@ -6,7 +6,18 @@ in vec4 worldPos;
 in vec2 waterTexCoords;
 in vec2 heightTexCoords;
 
-uniform vec3 cameraPosition;
+// Per view data, shared by every program
+layout(std140) uniform FrameData
+{
+    mat4 u_view;
+    mat4 u_projection;
+    mat4 u_camXY;
+    vec4 location_plane;
+    vec3 viewPos;
+    float lightIntensity;
+    vec3 lightPos;
+    vec3 lightCol;
+};
 
 uniform sampler2D toonWater;
 uniform sampler2D normalMap;
@@ -32,5 +43,5 @@ void main()
     FragColor = mix(FragColor, lightColor, lights);
     FragColor = mix(lightColor, FragColor, height);
 
-    float distance = length(cameraPosition - worldPos.xyz);
+    float distance = length(viewPos - worldPos.xyz);
 }
\ No newline at end of file
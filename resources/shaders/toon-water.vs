@@ -9,9 +9,19 @@ out vec2 heightTexCoords;
 
 // Uniforms for transformation matrices
 uniform mat4 u_model;
-uniform mat4 u_view;
-uniform mat4 u_projection;
-uniform mat4 u_camXY;
+
+// Per view data, shared by every program
+layout(std140) uniform FrameData
+{
+    mat4 u_view;
+    mat4 u_projection;
+    mat4 u_camXY;
+    vec4 location_plane;
+    vec3 viewPos;
+    float lightIntensity;
+    vec3 lightPos;
+    vec3 lightCol;
+};
 
 const float waterScale = 5;
 const float heightScale = 1024;
@@ -1,10 +1,16 @@
 #version 410 core
 layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec3 aNormal;
+layout(location = 1) in vec2 aNormal; // Octahedral
 layout(location = 2) in vec2 aTexCoords;
-layout(location = 3) in ivec4 aBoneIDs;
+layout(location = 3) in uvec4 aBoneIDs;
 layout(location = 4) in vec4 aWeights;
 
+// Per instance
+layout(location = 5) in mat4 aModel;
+layout(location = 9) in mat4 aNormalMatrix;
+layout(location = 13) in vec3 aInstanceColor;
+layout(location = 14) in int aBoneOffset;
+
 out VS_OUT
 {
     vec3 FragPos;
@@ -14,64 +20,79 @@ out VS_OUT
 }
 vs_out;
 
-uniform vec3 lightPos;
-
-uniform mat4 u_model;
-uniform mat4 u_view;
-uniform mat4 u_projection;
-uniform mat4 u_normal;
+// Per view data, shared by every program
+layout(std140) uniform FrameData
+{
+    mat4 u_view;
+    mat4 u_projection;
+    mat4 u_camXY;
+    vec4 location_plane;
+    vec3 viewPos;
+    float lightIntensity;
+    vec3 lightPos;
+    vec3 lightCol;
+};
 
-uniform vec4 location_plane;
+const int maxBoneInfluence = 4;
 
-uniform bool animated;
+// Skinning matrices of all instances, bone transform times inverse offset, four texels per matrix starting at aBoneOffset
+uniform samplerBuffer u_bonePalette;
 
-const int maxBones = 50;
-const int maxBoneInfluence = 4;
+mat4 boneTransform(int boneID)
+{
+    int base = aBoneOffset + 4 * boneID;
+    return mat4(texelFetch(u_bonePalette, base), texelFetch(u_bonePalette, base + 1), texelFetch(u_bonePalette, base + 2), texelFetch(u_bonePalette, base + 3));
+}
 
-uniform mat4 u_boneTransforms[maxBones];
-uniform mat4 u_inverseOffsets[maxBones];
+// Unfold a normal stored on the octahedron, see MeshUtil::pack
+vec3 octDecode(vec2 folded)
+{
+    vec3 normal = vec3(folded, 1.0 - abs(folded.x) - abs(folded.y));
+    if(normal.z < 0.0)
+        normal.xy = (1.0 - abs(normal.yx)) * vec2(normal.x >= 0.0 ? 1.0 : -1.0, normal.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(normal);
+}
 
 void main()
 {
+    vec3 normal = octDecode(aNormal);
+
     // Initialize the final position of the vertex
     vec4 finalPosition = vec4(0);
     vec3 finalNormal = vec3(0);
 
-    if(animated)
+    // Negative offset for instances without a skeleton
+    if(aBoneOffset >= 0)
     {
         // Apply the bone transforms based on the weights and bone IDs
         for(int i = 0; i < maxBoneInfluence; i++)
         {
-            int boneID = aBoneIDs[i];
+            int boneID = int(aBoneIDs[i]);
             float weight = aWeights[i];
 
             if(weight > 0.0)
             {
             // Apply the bone transform to the vertex position and normal
-                mat4 boneTransform = u_boneTransforms[boneID];
-                mat4 inverseOffset = u_inverseOffsets[boneID];
-
-                vec4 boneSpacePos = inverseOffset * vec4(aPos, 1.0);
-                vec4 transformedPos = boneTransform * boneSpacePos;
+                mat4 transform = boneTransform(boneID);
 
-                finalPosition += transformedPos * weight;
-                finalNormal += transpose(inverse(mat3(boneTransform * inverseOffset))) * aNormal * weight; // Use the rotation part of the matrix for normal
+                finalPosition += transform * vec4(aPos, 1.0) * weight;
+                finalNormal += transpose(inverse(mat3(transform))) * normal * weight; // Use the rotation part of the matrix for normal
             }
         }
     }
     else
     {
         finalPosition += vec4(aPos, 1);
-        finalNormal += aNormal;
+        finalNormal += normal;
     }
 
-    vec4 worldPosition = u_model * finalPosition;
+    vec4 worldPosition = aModel * finalPosition;
 
     gl_ClipDistance[0] = dot(worldPosition, location_plane);
 
     vs_out.TexCoords = aTexCoords;
     vs_out.FragPos = worldPosition.xyz;
-    vs_out.Normal = normalize(mat3(u_normal) * finalNormal);
+    vs_out.Normal = normalize(mat3(aNormalMatrix) * finalNormal);
     vs_out.lightDir = normalize(lightPos - worldPosition.xyz);
 
     gl_Position = u_projection * u_view * worldPosition;
@@ -17,8 +17,18 @@ uniform int dudvMapLayer;
 uniform int normalMapLayer;
 uniform sampler2D depthMap;
 
-uniform vec3 lightCol;
-uniform vec3 cameraPosition;
+// Per view data, shared by every program
+layout(std140) uniform FrameData
+{
+    mat4 u_view;
+    mat4 u_projection;
+    mat4 u_camXY;
+    vec4 location_plane;
+    vec3 viewPos;
+    float lightIntensity;
+    vec3 lightPos;
+    vec3 lightCol;
+};
 
 const float waveStrength = 0.05;
 uniform float moveOffset;
@@ -85,7 +95,7 @@ void main()
     waterColor = mix(waterColor, vec4(0.0, 0.25, 0.5, 1.0), 0.10) + vec4(specularHighlights, 0.0);
 
     // Calculate fog factor based on distance
-    float distance = length(cameraPosition - worldPos.xyz);
+    float distance = length(viewPos - worldPos.xyz);
     float fogFactor = clamp((fogEnd - distance) / (fogEnd - fogStart), 0.0, 1.0);
 
     // Adjust alpha based on water depth and fog
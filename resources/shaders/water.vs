@@ -9,14 +9,21 @@ out vec3 toCamera;
 out vec3 fromLight;
 out vec4 worldPos;
 
-uniform vec3 lightPos;
-uniform vec3 cameraPosition;
+// Per view data, shared by every program
+layout(std140) uniform FrameData
+{
+    mat4 u_view;
+    mat4 u_projection;
+    mat4 u_camXY;
+    vec4 location_plane;
+    vec3 viewPos;
+    float lightIntensity;
+    vec3 lightPos;
+    vec3 lightCol;
+};
 
 // Uniforms for transformation matrices
 uniform mat4 u_model;
-uniform mat4 u_view;
-uniform mat4 u_projection;
-uniform mat4 u_camXY;
 
 int tiling = 20;
 
@@ -27,6 +34,6 @@ void main() {
     projectionPosition = u_projection * u_view * worldPos;
     gl_Position = projectionPosition;
 
-    toCamera = normalize(cameraPosition - worldPos.xyz);
+    toCamera = normalize(viewPos - worldPos.xyz);
     fromLight = normalize(worldPos.xyz - lightPos);
 }
\ No newline at end of file
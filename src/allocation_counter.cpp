@@ -0,0 +1,42 @@
+#include "allocation_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    // Shared by all threads, so work spread over the job system adds up in one place
+    std::atomic<long long> countedAllocations{0};
+    thread_local int openScopes = 0;
+}
+
+long long AllocationCounter::counted()
+{
+    return countedAllocations.load(std::memory_order_relaxed);
+}
+
+AllocationCounter::Scope::Scope()
+{
+    openScopes++;
+}
+
+AllocationCounter::Scope::~Scope()
+{
+    openScopes--;
+}
+
+void *operator new(std::size_t size)
+{
+    if (openScopes > 0)
+        countedAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void *operator new[](std::size_t size) { return operator new(size); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
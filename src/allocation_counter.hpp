@@ -0,0 +1,18 @@
+#pragma once
+
+// Heap allocations made inside counting scopes, on any thread, for checking code that should not allocate
+namespace AllocationCounter
+{
+    // Process wide total of allocations made while some Scope was open on the allocating thread
+    long long counted();
+
+    // Counts the calling thread's allocations while alive, open one in every job of the work being checked
+    struct Scope
+    {
+        Scope();
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+};
@@ -2,101 +2,131 @@
 
 #include "pch.h"
 
+#include "animation/matrix_batch.hpp"
 #include "model/bone.h"
 
 void Animation::update(ModelData &ModelData, const float &alpha)
 {
-    switch (ModelData.model->modelType)
-    {
-    default:
-        updateGeneric(ModelData, alpha);
-        break;
-    }
-}
-
-void Animation::update(ModelData &ModelData, const float &alpha, std::vector<glm::mat4> &targetBones)
-{
-    switch (ModelData.model->modelType)
-    {
-    case ModelType::Yacht:
-        updateYachtBones(ModelData, alpha, targetBones);
-        break;
-    default:
+    if (ModelData.animated && ModelData.model->modelType == ModelType::Yacht)
+        updateYachtBones(ModelData, alpha);
+    else if (ModelData.animated || ModelData.physicsIndex >= 0)
         updateGeneric(ModelData, alpha);
-        break;
-    }
 }
 
 void Animation::updateGeneric(ModelData &ModelData, const float &alpha)
 {
     // Abreviations
     Model *model = ModelData.model;
-    Physics *physics = ModelData.physics->getReadBuffer();
+    const PhysicsState &physics = SceneManager::currentScene->physicsWorld.getReadState();
+    const int i = ModelData.physicsIndex;
 
     // Decompose transforms
-    glm::vec3 prevPos = physics->base.prevPos;
-    glm::vec3 currPos = physics->base.pos;
+    glm::vec3 prevPos = physics.base.prevPos[i];
+    glm::vec3 currPos = physics.base.pos[i];
 
-    glm::quat prevRot = physics->base.prevRot;
-    glm::quat currRot = physics->base.rot;
+    glm::quat prevRot = physics.base.prevRot[i];
+    glm::quat currRot = physics.base.rot[i];
 
     // Interpolate
     glm::vec3 interpPos = glm::mix(prevPos, currPos, alpha);
     glm::quat interpRot = glm::slerp(prevRot, currRot, alpha);
 
-    // Reconstruct matrix
-    glm::mat4 transform = glm::translate(glm::mat4(1.0f), interpPos) * glm::toMat4(interpRot);
-
     // Body Transform
-    ModelData.u_model = transform;
+    MatrixBatch::compose(&interpPos, &interpRot, 1, &ModelData.u_model);
 }
 
-void Animation::updateYachtBones(ModelData &ModelData, const float &alpha, std::vector<glm::mat4> &targetBones)
+void Animation::updateYachtBones(ModelData &ModelData, const float &alpha)
 {
     // Abreviations
     Model *model = ModelData.model;
-    Physics *physics = ModelData.physics->getReadBuffer();
+    const PhysicsWorld &world = SceneManager::currentScene->physicsWorld;
+    const PhysicsState &physics = world.getReadState();
+    const int i = ModelData.physicsIndex;
+    const int s = world.sailSlot[i];
+    const int d = world.drivingSlot[i];
+
+    // Decompose transforms
+    glm::vec3 prevPos = physics.base.prevPos[i];
+    glm::vec3 currPos = physics.base.pos[i];
+
+    glm::quat prevRot = physics.base.prevRot[i];
+    glm::quat currRot = physics.base.rot[i];
+
+    // Raw state of the last tick, at rest when nothing moved since the one before
+    std::array<float, 12> inputs = {currPos.x, currPos.y, currPos.z, currRot.x, currRot.y, currRot.z, currRot.w,
+                                    physics.driving.steeringAngle[d], physics.driving.wheelAngle[d],
+                                    physics.sail.MastAngle[s], physics.sail.BoomAngle[s], physics.sail.SailAngle[s]};
+    bool atRest = prevPos == currPos && prevRot == currRot &&
+                  physics.driving.prevSteeringAngle[d] == inputs[7] && physics.driving.prevWheelAngle[d] == inputs[8] &&
+                  physics.sail.prevMastAngle[s] == inputs[9] && physics.sail.prevBoomAngle[s] == inputs[10] && physics.sail.prevSailAngle[s] == inputs[11];
+
+    // Same rest state as the published pose, a yacht at rest costs nothing
+    if (atRest && ModelData.posed && inputs == ModelData.poseInputs)
+    {
+        skippedModels.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
 
-    BodyVariables *body = nullptr;
-    SailVariables *sail = nullptr;
-    DrivingVariables *driving = nullptr;
-    physics->getVariablePointers(body, sail, driving);
+    // Interpolate between physics ticks, a yacht at rest is posed from the raw state so alpha cannot change it
+    float steeringAngle = inputs[7];
+    float wheelAngle = inputs[8];
+    float mastAngle = inputs[9];
+    float boomAngle = inputs[10];
+    float sailAngle = inputs[11];
+    glm::vec3 interpPos = currPos;
+    glm::quat interpRot = currRot;
+    if (!atRest)
+    {
+        steeringAngle = glm::mix(physics.driving.prevSteeringAngle[d], steeringAngle, alpha);
+        wheelAngle = glm::mix(physics.driving.prevWheelAngle[d], wheelAngle, alpha);
+        mastAngle = glm::mix(physics.sail.prevMastAngle[s], mastAngle, alpha);
+        boomAngle = glm::mix(physics.sail.prevBoomAngle[s], boomAngle, alpha);
+        sailAngle = glm::mix(physics.sail.prevSailAngle[s], sailAngle, alpha);
+        interpPos = glm::mix(prevPos, currPos, alpha);
+        interpRot = glm::slerp(prevRot, currRot, alpha);
+    }
 
-    // Interpolate between physics ticks
-    float steeringAngle = glm::mix(driving->prevSteeringAngle, driving->steeringAngle, alpha);
-    float wheelAngle = glm::mix(driving->prevWheelAngle, driving->wheelAngle, alpha);
-    float mastAngle = glm::mix(sail->prevMastAngle, sail->MastAngle, alpha);
-    float boomAngle = glm::mix(sail->prevBoomAngle, sail->BoomAngle, alpha);
-    float sailAngle = glm::mix(sail->prevSailAngle, sail->SailAngle, alpha);
+    // Body and the seven driven bones as rotation and translation pairs, composed in one batch
+    enum Part { Body, Fork, WheelFront, WheelLeft, WheelRight, Mast, Boom, Sail, PartCount };
+    glm::vec3 positions[PartCount] = {};
+    glm::quat rotations[PartCount];
+    glm::mat4 transforms[PartCount];
 
-    // Decompose transforms
-    glm::vec3 prevPos = physics->base.prevPos;
-    glm::vec3 currPos = physics->base.pos;
+    positions[Body] = interpPos;
+    rotations[Body] = interpRot;
 
-    glm::quat prevRot = physics->base.prevRot;
-    glm::quat currRot = physics->base.rot;
+    // Wheel transforms
+    rotations[Fork] = glm::angleAxis(glm::radians(steeringAngle * 2), glm::vec3(0.0f, -1.0f, 0.0f));
+    rotations[WheelFront] = glm::angleAxis(glm::radians(wheelAngle), glm::vec3(0.0f, 1.0f, 0.0f));
+    rotations[WheelLeft] = glm::angleAxis(glm::radians(wheelAngle), glm::vec3(0.0f, 1.0f, 0.0f));
+    rotations[WheelRight] = glm::angleAxis(glm::radians(-wheelAngle), glm::vec3(0.0f, 1.0f, 0.0f));
 
-    // Interpolate
-    glm::vec3 interpPos = glm::mix(prevPos, currPos, alpha);
-    glm::quat interpRot = glm::slerp(prevRot, currRot, alpha);
+    // Sail setup transform
+    rotations[Mast] = glm::angleAxis(mastAngle, glm::vec3(0.0f, 1.0f, 0.0f));
+    rotations[Boom] = glm::angleAxis(boomAngle - mastAngle, glm::vec3(0.0f, 0.0f, 1.0f));
+    rotations[Sail] = glm::angleAxis(sailAngle - mastAngle, glm::vec3(0.0f, 0.0f, 1.0f));
 
-    // Reconstruct matrix
-    glm::mat4 transform = glm::translate(glm::mat4(1.0f), interpPos) * glm::toMat4(interpRot);
+    MatrixBatch::compose(positions, rotations, PartCount, transforms);
 
     // Body Transform
-    ModelData.u_model = transform;
+    ModelData.u_model = transforms[Body];
 
-    // Wheel transforms
-    model->boneHierarchy["Armature_Fork"]->transform = glm::rotate(glm::mat4(1.0f), glm::radians(steeringAngle * 2), glm::vec3(0.0f, -1.0f, 0.0f));
-    model->boneHierarchy["Armature_Wheel_Front"]->transform = glm::rotate(glm::mat4(1.0f), glm::radians(wheelAngle), glm::vec3(0.0f, 1.0f, 0.0f));
-    model->boneHierarchy["Armature_Wheel_Left"]->transform = glm::rotate(glm::mat4(1.0f), glm::radians(wheelAngle), glm::vec3(0.0f, 1.0f, 0.0f));
-    model->boneHierarchy["Armature_Wheel_Right"]->transform = glm::rotate(glm::mat4(1.0f), glm::radians(-wheelAngle), glm::vec3(0.0f, 1.0f, 0.0f));
+    // Local animation of every bone, most stay in their bind pose
+    const YachtBones &bones = model->yachtBones;
+    std::vector<glm::mat4> &targetBones = ModelData.bonePalette->write();
+    std::fill(targetBones.begin(), targetBones.end(), glm::mat4(1.0f));
 
-    // Sail setup transform
-    model->boneHierarchy["Armature_Mast"]->transform = glm::rotate(glm::mat4(1.0f), mastAngle, glm::vec3(0.0f, 1.0f, 0.0f));
-    model->boneHierarchy["Armature_Boom"]->transform = glm::rotate(glm::mat4(1.0f), boomAngle - mastAngle, glm::vec3(0.0f, 0.0f, 1.0f));
-    model->boneHierarchy["Armature_Sail"]->transform = glm::rotate(glm::mat4(1.0f), sailAngle - mastAngle, glm::vec3(0.0f, 0.0f, 1.0f));
+    int partBones[PartCount] = {-1, bones.fork, bones.wheelFront, bones.wheelLeft, bones.wheelRight, bones.mast, bones.boom, bones.sail};
+    for (int part = Fork; part < PartCount; part++)
+        if (partBones[part] >= 0)
+            targetBones[partBones[part]] = transforms[part];
 
-    // Push updates to children
+    // One pass down the flattened hierarchy turns them into the palette
     model->updateBoneTransforms(targetBones);
+    ModelData.bonePalette->publish();
+
+    // Only a rest pose can be reused, an interpolated one changes with alpha
+    ModelData.poseInputs = inputs;
+    ModelData.posed = atRest;
+    posedModels.fetch_add(1, std::memory_order_relaxed);
 };
\ No newline at end of file
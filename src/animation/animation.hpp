@@ -2,6 +2,7 @@
 
 #include <glm/glm.hpp>
 
+#include <atomic>
 #include <vector>
 #include <unordered_map>
 #include <string>
@@ -11,9 +12,12 @@ struct ModelData;
 
 namespace Animation
 {
+    // Yachts of the last animation pass that were posed, and that kept their pose because their physics state had not moved
+    inline std::atomic<int> posedModels = 0, skippedModels = 0;
+
+    // Touches only this model, so models can be updated in parallel
     void update(ModelData &ModelData, const float &alpha);
-    void update(ModelData &ModelData, const float &alpha, std::vector<glm::mat4> &targetBones);
 
     void updateGeneric(ModelData &ModelData, const float &alpha);
-    void updateYachtBones(ModelData &ModelData, const float &alpha, std::vector<glm::mat4> &targetBones);
+    void updateYachtBones(ModelData &ModelData, const float &alpha);
 };
\ No newline at end of file
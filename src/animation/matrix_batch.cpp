@@ -0,0 +1,142 @@
+#include "animation/matrix_batch.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MATRIX_BATCH_SSE2 1
+#endif
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define MATRIX_BATCH_AVX 1
+#endif
+
+namespace
+{
+    // Column major product of two matrices, columns stay in registers
+    inline void multiply(const float *a, const float *b, float *out)
+    {
+#if defined(MATRIX_BATCH_AVX)
+        // Two result columns per step, each half broadcasts its own column of b
+        __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a));
+        __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 4));
+        __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 8));
+        __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 12));
+
+        for (int j = 0; j < 16; j += 8)
+        {
+            __m256 columns = _mm256_loadu_ps(b + j);
+            __m256 result = _mm256_mul_ps(a0, _mm256_shuffle_ps(columns, columns, 0x00));
+            result = _mm256_add_ps(result, _mm256_mul_ps(a1, _mm256_shuffle_ps(columns, columns, 0x55)));
+            result = _mm256_add_ps(result, _mm256_mul_ps(a2, _mm256_shuffle_ps(columns, columns, 0xAA)));
+            result = _mm256_add_ps(result, _mm256_mul_ps(a3, _mm256_shuffle_ps(columns, columns, 0xFF)));
+            _mm256_storeu_ps(out + j, result);
+        }
+#elif defined(MATRIX_BATCH_SSE2)
+        __m128 a0 = _mm_loadu_ps(a), a1 = _mm_loadu_ps(a + 4), a2 = _mm_loadu_ps(a + 8), a3 = _mm_loadu_ps(a + 12);
+
+        // Load all of b first, out may be b
+        __m128 columns[4] = {_mm_loadu_ps(b), _mm_loadu_ps(b + 4), _mm_loadu_ps(b + 8), _mm_loadu_ps(b + 12)};
+        for (int j = 0; j < 4; j++)
+        {
+            __m128 column = columns[j];
+            __m128 result = _mm_mul_ps(a0, _mm_shuffle_ps(column, column, 0x00));
+            result = _mm_add_ps(result, _mm_mul_ps(a1, _mm_shuffle_ps(column, column, 0x55)));
+            result = _mm_add_ps(result, _mm_mul_ps(a2, _mm_shuffle_ps(column, column, 0xAA)));
+            result = _mm_add_ps(result, _mm_mul_ps(a3, _mm_shuffle_ps(column, column, 0xFF)));
+            _mm_storeu_ps(out + 4 * j, result);
+        }
+#else
+        float result[16];
+        for (int j = 0; j < 4; j++)
+            for (int i = 0; i < 4; i++)
+                result[4 * j + i] = a[i] * b[4 * j] + a[4 + i] * b[4 * j + 1] + a[8 + i] * b[4 * j + 2] + a[12 + i] * b[4 * j + 3];
+        for (int k = 0; k < 16; k++)
+            out[k] = result[k];
+#endif
+    }
+
+    // Same terms as glm::toMat4 followed by glm::translate
+    inline void composeOne(const glm::vec3 &p, const glm::quat &q, glm::mat4 &out)
+    {
+        float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+        out[0] = glm::vec4(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f);
+        out[1] = glm::vec4(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f);
+        out[2] = glm::vec4(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f);
+        out[3] = glm::vec4(p, 1.0f);
+    }
+}
+
+void MatrixBatch::compose(const glm::vec3 *positions, const glm::quat *rotations, size_t count, glm::mat4 *out)
+{
+    size_t n = 0;
+
+#ifdef MATRIX_BATCH_SSE2
+    const __m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f), zero = _mm_setzero_ps();
+
+    for (; n + 4 <= count; n += 4)
+    {
+        // One lane per quaternion, whatever order glm stores the components in
+        __m128 x = _mm_setr_ps(rotations[n].x, rotations[n + 1].x, rotations[n + 2].x, rotations[n + 3].x);
+        __m128 y = _mm_setr_ps(rotations[n].y, rotations[n + 1].y, rotations[n + 2].y, rotations[n + 3].y);
+        __m128 z = _mm_setr_ps(rotations[n].z, rotations[n + 1].z, rotations[n + 2].z, rotations[n + 3].z);
+        __m128 w = _mm_setr_ps(rotations[n].w, rotations[n + 1].w, rotations[n + 2].w, rotations[n + 3].w);
+
+        __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+        __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+        __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+        // Rows of the rotation part, one lane per matrix
+        __m128 m00 = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz)));
+        __m128 m01 = _mm_mul_ps(two, _mm_add_ps(xy, wz));
+        __m128 m02 = _mm_mul_ps(two, _mm_sub_ps(xz, wy));
+        __m128 m10 = _mm_mul_ps(two, _mm_sub_ps(xy, wz));
+        __m128 m11 = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz)));
+        __m128 m12 = _mm_mul_ps(two, _mm_add_ps(yz, wx));
+        __m128 m20 = _mm_mul_ps(two, _mm_add_ps(xz, wy));
+        __m128 m21 = _mm_mul_ps(two, _mm_sub_ps(yz, wx));
+        __m128 m22 = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy)));
+
+        // Transposed, lane k of every row becomes a column of matrix k
+        __m128 column0[4] = {m00, m01, m02, zero};
+        __m128 column1[4] = {m10, m11, m12, zero};
+        __m128 column2[4] = {m20, m21, m22, zero};
+        _MM_TRANSPOSE4_PS(column0[0], column0[1], column0[2], column0[3]);
+        _MM_TRANSPOSE4_PS(column1[0], column1[1], column1[2], column1[3]);
+        _MM_TRANSPOSE4_PS(column2[0], column2[1], column2[2], column2[3]);
+
+        for (int k = 0; k < 4; k++)
+        {
+            float *matrix = &out[n + k][0][0];
+            _mm_storeu_ps(matrix, column0[k]);
+            _mm_storeu_ps(matrix + 4, column1[k]);
+            _mm_storeu_ps(matrix + 8, column2[k]);
+            _mm_storeu_ps(matrix + 12, _mm_setr_ps(positions[n + k].x, positions[n + k].y, positions[n + k].z, 1.0f));
+        }
+    }
+#endif
+
+    for (; n < count; n++)
+        composeOne(positions[n], rotations[n], out[n]);
+}
+
+void MatrixBatch::chain(const glm::mat4 *bind, const int *order, const int *parents, size_t count, glm::mat4 *palette)
+{
+    // Parents come first, their entry is already final when a child reads it
+    for (size_t i = 0; i < count; i++)
+    {
+        float *bone = &palette[order[i]][0][0];
+        multiply(&bind[i][0][0], bone, bone);
+
+        if (parents[i] >= 0)
+            multiply(&palette[parents[i]][0][0], bone, bone);
+    }
+}
+
+void MatrixBatch::product(const glm::mat4 *a, const glm::mat4 *b, size_t count, glm::mat4 *out)
+{
+    for (size_t i = 0; i < count; i++)
+        multiply(&a[i][0][0], &b[i][0][0], &out[i][0][0]);
+}
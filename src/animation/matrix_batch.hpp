@@ -0,0 +1,20 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstddef>
+
+// Matrix work of the animation pass in batches, SSE or AVX where the compiler targets it, scalar otherwise
+namespace MatrixBatch
+{
+    // out[i] = translate(positions[i]) * toMat4(rotations[i]), four at a time
+    void compose(const glm::vec3 *positions, const glm::quat *rotations, size_t count, glm::mat4 *out);
+
+    // Bones in parent before child order, palette[order[i]] holds the local transform and becomes
+    // palette[parents[i]] * bind[i] * local, or bind[i] * local for roots
+    void chain(const glm::mat4 *bind, const int *order, const int *parents, size_t count, glm::mat4 *palette);
+
+    // out[i] = a[i] * b[i], out may be b
+    void product(const glm::mat4 *a, const glm::mat4 *b, size_t count, glm::mat4 *out);
+};
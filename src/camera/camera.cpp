@@ -3,15 +3,35 @@
 #include "pch.h"
 
 // Update cam matrices from positions etc
-void Camera::update()
+void Camera::update(glm::vec3 position, glm::vec3 rotation, const glm::mat4 &projection)
 {
-    setCamDirection(getRotation());
-    genProjectionMatrix();
-    glm::vec3 position = getPosition();
+    framePosition = position;
+    frameRotation = rotation;
+
+    setCamDirection(rotation);
+    u_projection = projection;
     genViewMatrix(position);
     u_camXY = glm::translate(glm::mat4(1.0f), glm::vec3(position[0], position[1], 0));
 }
 
+// Hand the input state to render prep, called from the main thread only
+void Camera::publishView()
+{
+    std::lock_guard<std::mutex> lock(viewMutex);
+    publishedView.freeCam = freeCam;
+    publishedView.positionFree = cameraPositionFree;
+    publishedView.rotationFree = glm::vec3(pitchFree, yawFree, rollFree);
+    publishedView.rotationOffset = glm::vec3(pitch + pitchOffset, yawOffset, roll + rollOffset);
+    publishedView.projection = projectionMatrix();
+}
+
+// Copy of the last published view, safe from any thread
+Camera::View Camera::latestView()
+{
+    std::lock_guard<std::mutex> lock(viewMutex);
+    return publishedView;
+}
+
 // Reset cam to starting position/orientation
 void Camera::reset()
 {
@@ -46,22 +66,48 @@ void Camera::reset()
         setCamDirection(getRotation());
         genViewMatrix(getPosition());
     }
+
+    publishView();
 }
 
 // Set camera direction from rotation angles
 void Camera::setCamDirection(glm::vec3 rotation)
+{
+    cameraViewDirection = directionFromRotation(rotation);
+}
+
+// View matrix
+void Camera::genViewMatrix(glm::vec3 position)
+{
+    cameraRight = glm::normalize(glm::cross(worldUp, -cameraViewDirection));
+    cameraUp = glm::normalize(glm::cross(-cameraViewDirection, cameraRight));
+
+    u_view = viewMatrix(position, cameraViewDirection);
+}
+
+glm::vec3 Camera::directionFromRotation(glm::vec3 rotation)
 {
     float p = rotation[0]; // pitch
     float y = rotation[1]; // yaw
     float r = rotation[2]; // roll
 
-    cameraViewDirection = glm::normalize(glm::vec3(cos(-p) * sin(y),
-                                                   cos(-p) * cos(y),
-                                                   sin(-p)));
+    return glm::normalize(glm::vec3(cos(-p) * sin(y),
+                                    cos(-p) * cos(y),
+                                    sin(-p)));
+}
+
+glm::mat4 Camera::viewMatrix(glm::vec3 position, glm::vec3 direction)
+{
+    glm::vec3 right = glm::normalize(glm::cross(worldUp, -direction));
+    glm::vec3 up = glm::normalize(glm::cross(-direction, right));
+
+    return glm::lookAt(position,             // Camera Position
+                       position + direction, // Target Position
+                       up                    // Up vector
+    );
 }
 
-// Projection Matrix
-void Camera::genProjectionMatrix()
+glm::mat4 Camera::projectionMatrix()
 {
     float aspect = (float)WindowManager::screenWidth / (float)WindowManager::screenHeight;
 
@@ -69,22 +115,10 @@ void Camera::genProjectionMatrix()
 
     float vFov = 2.0f * atan(tan(hFov / 2.0f) / aspect);
 
-    u_projection = glm::perspective(vFov,
-                                    (float)WindowManager::screenWidth / (float)WindowManager::screenHeight,
-                                    0.1f,
-                                    1000.0f);
-}
-
-// View matrix
-void Camera::genViewMatrix(glm::vec3 position)
-{
-    cameraRight = glm::normalize(glm::cross(worldUp, -cameraViewDirection));
-    cameraUp = glm::normalize(glm::cross(-cameraViewDirection, cameraRight));
-
-    u_view = glm::lookAt(position,                       // Camera Position
-                         position + cameraViewDirection, // Target Position
-                         cameraUp                        // Up vector
-    );
+    return glm::perspective(vFov,
+                            (float)WindowManager::screenWidth / (float)WindowManager::screenHeight,
+                            0.1f,
+                            1000.0f);
 }
 
 // Get camera position
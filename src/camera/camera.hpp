@@ -1,5 +1,7 @@
 #pragma once
 
+#include <mutex>
+
 #include <glm/glm.hpp>
 
 namespace Camera
@@ -25,12 +27,40 @@ namespace Camera
     // Booleans for tracking cam state
     inline bool cameraMoved, freeCam;
 
-    void update();
+    // Position and orientation the current frame renders from, set by update
+    inline glm::vec3 framePosition, frameRotation;
+
+    // Camera input as the main thread last published it, render prep keeps a copy in its buffer
+    struct View
+    {
+        bool freeCam = false;
+        glm::vec3 positionFree = glm::vec3(0.0f);
+        glm::vec3 rotationFree = glm::vec3(0.0f);
+
+        // Pitch and roll with the user's offsets, and the yaw offset added to the followed yaw
+        glm::vec3 rotationOffset = glm::vec3(0.0f);
+        glm::mat4 projection = glm::mat4(1.0f);
+
+        // Free cam position, or the followed position of the fixed cam
+        glm::vec3 position(glm::vec3 followPosition) const { return freeCam ? positionFree : followPosition; }
+        glm::vec3 rotation(float followYaw) const { return freeCam ? rotationFree : rotationOffset + glm::vec3(0.0f, followYaw, 0.0f); }
+    };
+    inline std::mutex viewMutex;
+    inline View publishedView;
+
+    void publishView();
+    View latestView();
+
+    void update(glm::vec3 position, glm::vec3 rotation, const glm::mat4 &projection);
     void reset();
     void setCamDirection(glm::vec3 rotation);
     void genViewMatrix(glm::vec3 position);
-    void genProjectionMatrix();
 
     glm::vec3 getPosition();
     glm::vec3 getRotation();
+
+    // Matrices of any camera, without touching the globals above
+    glm::vec3 directionFromRotation(glm::vec3 rotation);
+    glm::mat4 viewMatrix(glm::vec3 position, glm::vec3 direction);
+    glm::mat4 projectionMatrix();
 };
\ No newline at end of file
@@ -136,6 +136,7 @@ int main()
             break;
         }
 
+        Render::endFrame();
         glfwSwapBuffers(WindowManager::window);
         InputManager::update();
         ControllerManager::update();
@@ -24,9 +24,20 @@ void Mesh<VertexType>::uploadToGPU()
         // Bind Vertex Array Object
         glBindVertexArray(VAO);
 
-        // Send vertices of mesh to GPU
+        // Send vertices of mesh to GPU, packed where the type has a smaller layout
         glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(VertexType), vertices.data(), GL_STATIC_DRAW);
+
+        using GpuVertexType = typename GpuVertex<VertexType>::type;
+        if constexpr (std::is_same_v<GpuVertexType, VertexType>)
+            glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(VertexType), vertices.data(), GL_STATIC_DRAW);
+        else
+        {
+            std::vector<GpuVertexType> packed(vertices.size());
+            for (size_t i = 0; i < vertices.size(); i++)
+                packed[i] = MeshUtil::pack(vertices[i]);
+
+            glBufferData(GL_ARRAY_BUFFER, packed.size() * sizeof(GpuVertexType), packed.data(), GL_STATIC_DRAW);
+        }
 
         // Send element indices to GPU
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
@@ -42,55 +53,62 @@ void Mesh<VertexType>::uploadToGPU()
 template <typename VertexType>
 void Mesh<VertexType>::draw()
 {
-    glBindVertexArray(VAO);
+    // Stays bound, the next mesh with the same vertex array skips the bind
+    MeshUtil::bindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
+}
 
-    glBindVertexArray(0);
+template <typename VertexType>
+void Mesh<VertexType>::drawInstanced(unsigned int instanceBuffer, size_t instanceOffset, int instanceCount)
+{
+    MeshUtil::bindVertexArray(VAO);
+    MeshUtil::setupInstanceAttributes(instanceBuffer, instanceOffset);
+    glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0, instanceCount);
 }
 
 template <>
 void Mesh<VertexAnimated>::setupVertexAttributes()
 {
     glEnableVertexAttribArray(0); // Position
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexAnimated), (void *)offsetof(VertexAnimated, Position));
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(PackedVertexAnimated), (void *)offsetof(PackedVertexAnimated, Position));
 
-    glEnableVertexAttribArray(1); // Normal
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VertexAnimated), (void *)offsetof(VertexAnimated, Normal));
+    glEnableVertexAttribArray(1); // Octahedral normal
+    glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertexAnimated), (void *)offsetof(PackedVertexAnimated, Normal));
 
     glEnableVertexAttribArray(2); // TexCoords
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(VertexAnimated), (void *)offsetof(VertexAnimated, TexCoords));
+    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertexAnimated), (void *)offsetof(PackedVertexAnimated, TexCoords));
 
     glEnableVertexAttribArray(3); // Bone IDs (integers!)
-    glVertexAttribIPointer(3, 4, GL_INT, sizeof(VertexAnimated), (void *)offsetof(VertexAnimated, BoneIDs));
+    glVertexAttribIPointer(3, 4, GL_UNSIGNED_BYTE, sizeof(PackedVertexAnimated), (void *)offsetof(PackedVertexAnimated, BoneIDs));
 
     glEnableVertexAttribArray(4); // Weights
-    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(VertexAnimated), (void *)offsetof(VertexAnimated, Weights));
+    glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PackedVertexAnimated), (void *)offsetof(PackedVertexAnimated, Weights));
 }
 
 template <>
 void Mesh<VertexTextured>::setupVertexAttributes()
 {
     glEnableVertexAttribArray(0); // Position
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexTextured), (void *)offsetof(VertexTextured, Position));
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(PackedVertexTextured), (void *)offsetof(PackedVertexTextured, Position));
 
-    glEnableVertexAttribArray(1); // Normal
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VertexTextured), (void *)offsetof(VertexTextured, Normal));
+    glEnableVertexAttribArray(1); // Octahedral normal
+    glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertexTextured), (void *)offsetof(PackedVertexTextured, Normal));
 
     glEnableVertexAttribArray(2); // TexCoords
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(VertexTextured), (void *)offsetof(VertexTextured, TexCoords));
+    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertexTextured), (void *)offsetof(PackedVertexTextured, TexCoords));
 }
 
 template <>
 void Mesh<VertexSimple>::setupVertexAttributes()
 {
     glEnableVertexAttribArray(0); // Position
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexSimple), (void *)offsetof(VertexSimple, Position));
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(PackedVertexSimple), (void *)offsetof(PackedVertexSimple, Position));
 
-    glEnableVertexAttribArray(1); // Normal
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VertexSimple), (void *)offsetof(VertexSimple, Normal));
+    glEnableVertexAttribArray(1); // Octahedral normal
+    glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertexSimple), (void *)offsetof(PackedVertexSimple, Normal));
 
     glEnableVertexAttribArray(2); // Color
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(VertexSimple), (void *)offsetof(VertexSimple, Color));
+    glVertexAttribPointer(2, 3, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PackedVertexSimple), (void *)offsetof(PackedVertexSimple, Color));
 }
 
 template <>
@@ -5,6 +5,8 @@
 #include <string>
 #include <vector>
 
+#include "mesh/mesh_defs.h"
+
 enum class shaderID;
 
 template <typename VertexType>
@@ -16,10 +18,12 @@ public:
     std::vector<unsigned int> indices;
     shaderID shader;
     unsigned int VAO, VBO, EBO;
+    Bounds bounds;
 
     Mesh(std::vector<VertexType> vertices, std::vector<unsigned int> indices, shaderID shader);
 
     void draw();
+    void drawInstanced(unsigned int instanceBuffer, size_t instanceOffset, int instanceCount);
     void setupVertexAttributes();
     void uploadToGPU();
     glm::vec3 furthestInDirection(glm::vec3 worldDirection, const glm::mat4 u_model);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -35,4 +36,75 @@ struct VertexSkybox
 struct VertexHitbox
 {
     glm::vec3 Position;
-};
\ No newline at end of file
+};
+
+// Layouts the GPU reads, the float vertices above stay on the CPU for bounds, hulls and merging
+// Normals are octahedral snorm16, texture coordinates half floats, weights unorm8 summing to one
+struct PackedVertexAnimated
+{
+    glm::vec3 Position;
+    int16_t Normal[2];
+    uint16_t TexCoords[2];
+    uint8_t BoneIDs[4];
+    uint8_t Weights[4];
+};
+static_assert(sizeof(PackedVertexAnimated) == 28, "Packed animated vertex should stay at 28 bytes");
+
+struct PackedVertexSimple
+{
+    glm::vec3 Position;
+    int16_t Normal[2];
+    uint8_t Color[4];
+};
+static_assert(sizeof(PackedVertexSimple) == 20, "Packed simple vertex should stay at 20 bytes");
+
+struct PackedVertexTextured
+{
+    glm::vec3 Position;
+    int16_t Normal[2];
+    uint16_t TexCoords[2];
+};
+static_assert(sizeof(PackedVertexTextured) == 20, "Packed textured vertex should stay at 20 bytes");
+
+// Vertex type a mesh uploads, itself unless it has a packed layout
+template <typename VertexType>
+struct GpuVertex
+{
+    using type = VertexType;
+};
+
+template <>
+struct GpuVertex<VertexAnimated>
+{
+    using type = PackedVertexAnimated;
+};
+
+template <>
+struct GpuVertex<VertexSimple>
+{
+    using type = PackedVertexSimple;
+};
+
+template <>
+struct GpuVertex<VertexTextured>
+{
+    using type = PackedVertexTextured;
+};
+
+// Box and sphere around a mesh in its own space
+struct Bounds
+{
+    glm::vec3 min = glm::vec3(0.0f);
+    glm::vec3 max = glm::vec3(0.0f);
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = 0.0f;
+};
+
+// Per instance attributes of an instanced draw, read with a divisor of one
+struct InstanceData
+{
+    glm::mat4 model;
+    glm::mat4 normal;
+    glm::vec3 color;
+    int boneOffset = -1; // First texel of the bone palette, -1 without a skeleton
+};
@@ -2,6 +2,45 @@
 
 #include "pch.h"
 
+#include <glm/gtc/packing.hpp>
+
+#include <cmath>
+
+namespace
+{
+    int16_t snorm16(float value)
+    {
+        return static_cast<int16_t>(std::round(glm::clamp(value, -1.0f, 1.0f) * 32767.0f));
+    }
+
+    // Unit normal folded onto the octahedron and flattened to two components, the shaders unfold it in octDecode
+    void octEncode(glm::vec3 normal, int16_t out[2])
+    {
+        float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+        if (length <= 0.0f)
+        {
+            out[0] = out[1] = 0;
+            return;
+        }
+
+        glm::vec2 folded = glm::vec2(normal) / length;
+        if (normal.z < 0.0f)
+        {
+            glm::vec2 sign(folded.x >= 0.0f ? 1.0f : -1.0f, folded.y >= 0.0f ? 1.0f : -1.0f);
+            folded = glm::vec2(1.0f - std::abs(folded.y), 1.0f - std::abs(folded.x)) * sign;
+        }
+
+        out[0] = snorm16(folded.x);
+        out[1] = snorm16(folded.y);
+    }
+
+    void packTexCoords(glm::vec2 texCoords, uint16_t out[2])
+    {
+        out[0] = glm::packHalf1x16(texCoords.x);
+        out[1] = glm::packHalf1x16(texCoords.y);
+    }
+}
+
 unsigned int MeshUtil::setupSkyBoxMesh()
 {
     float skyboxVertices[] = {
@@ -72,4 +111,103 @@ unsigned int MeshUtil::setupSkyBoxMesh()
     glBindVertexArray(0); // Unbind VAO
 
     return skyboxVAO;
-}
\ No newline at end of file
+}
+
+PackedVertexAnimated MeshUtil::pack(const VertexAnimated &vertex)
+{
+    PackedVertexAnimated packed{};
+    packed.Position = vertex.Position;
+    octEncode(vertex.Normal, packed.Normal);
+    packTexCoords(vertex.TexCoords, packed.TexCoords);
+
+    float total = 0.0f;
+    for (int k = 0; k < 4; k++)
+    {
+        if (vertex.BoneIDs[k] < 0 || vertex.BoneIDs[k] > 255)
+            std::cerr << "Error: Bone index does not fit a packed vertex: " << vertex.BoneIDs[k] << std::endl;
+
+        packed.BoneIDs[k] = static_cast<uint8_t>(glm::clamp(vertex.BoneIDs[k], 0, 255));
+        total += vertex.Weights[k];
+    }
+
+    // Unweighted vertices stay at zero, the shaders leave them alone as before
+    if (total <= 0.0f)
+        return packed;
+
+    // Normalized, whatever rounding loses or adds goes to the heaviest bone so the bytes sum to 255
+    int sum = 0, heaviest = 0;
+    for (int k = 0; k < 4; k++)
+    {
+        packed.Weights[k] = static_cast<uint8_t>(std::round(vertex.Weights[k] / total * 255.0f));
+        sum += packed.Weights[k];
+        if (vertex.Weights[k] > vertex.Weights[heaviest])
+            heaviest = k;
+    }
+    packed.Weights[heaviest] = static_cast<uint8_t>(packed.Weights[heaviest] + 255 - sum);
+
+    return packed;
+}
+
+PackedVertexSimple MeshUtil::pack(const VertexSimple &vertex)
+{
+    PackedVertexSimple packed{};
+    packed.Position = vertex.Position;
+    octEncode(vertex.Normal, packed.Normal);
+
+    for (int k = 0; k < 3; k++)
+        packed.Color[k] = static_cast<uint8_t>(std::round(glm::clamp(vertex.Color[k], 0.0f, 1.0f) * 255.0f));
+    packed.Color[3] = 255;
+
+    return packed;
+}
+
+PackedVertexTextured MeshUtil::pack(const VertexTextured &vertex)
+{
+    PackedVertexTextured packed{};
+    packed.Position = vertex.Position;
+    octEncode(vertex.Normal, packed.Normal);
+    packTexCoords(vertex.TexCoords, packed.TexCoords);
+
+    return packed;
+}
+
+void MeshUtil::bindVertexArray(unsigned int vertexArray)
+{
+    if (vertexArray == boundVertexArray)
+        return;
+
+    glBindVertexArray(vertexArray);
+    boundVertexArray = vertexArray;
+    vertexArrayBinds++;
+}
+
+void MeshUtil::invalidateVertexArray()
+{
+    // Other code binds vertex arrays directly, so the next mesh always binds its own
+    boundVertexArray = ~0u;
+}
+
+void MeshUtil::setupInstanceAttributes(unsigned int instanceBuffer, size_t offset)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+
+    // Model and normal matrix, a column per location
+    for (int column = 0; column < 4; column++)
+    {
+        glEnableVertexAttribArray(5 + column);
+        glVertexAttribPointer(5 + column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void *)(offset + offsetof(InstanceData, model) + column * sizeof(glm::vec4)));
+        glVertexAttribDivisor(5 + column, 1);
+
+        glEnableVertexAttribArray(9 + column);
+        glVertexAttribPointer(9 + column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void *)(offset + offsetof(InstanceData, normal) + column * sizeof(glm::vec4)));
+        glVertexAttribDivisor(9 + column, 1);
+    }
+
+    glEnableVertexAttribArray(13); // Color
+    glVertexAttribPointer(13, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void *)(offset + offsetof(InstanceData, color)));
+    glVertexAttribDivisor(13, 1);
+
+    glEnableVertexAttribArray(14); // Bone palette offset (integer!)
+    glVertexAttribIPointer(14, 1, GL_INT, sizeof(InstanceData), (void *)(offset + offsetof(InstanceData, boneOffset)));
+    glVertexAttribDivisor(14, 1);
+}
@@ -11,6 +11,28 @@
 
 namespace MeshUtil
 {
+    // Box around the vertex positions, and the sphere around its centre that holds all of them
+    template <typename VertexType>
+    Bounds computeBounds(const std::vector<VertexType> &vertices)
+    {
+        Bounds bounds;
+        if (vertices.empty())
+            return bounds;
+
+        bounds.min = bounds.max = vertices[0].Position;
+        for (const VertexType &vertex : vertices)
+        {
+            bounds.min = glm::min(bounds.min, vertex.Position);
+            bounds.max = glm::max(bounds.max, vertex.Position);
+        }
+
+        bounds.center = 0.5f * (bounds.min + bounds.max);
+        for (const VertexType &vertex : vertices)
+            bounds.radius = glm::max(bounds.radius, glm::distance(bounds.center, vertex.Position));
+
+        return bounds;
+    }
+
     // Mesh generators
     template <typename VertexType>
     Mesh<VertexType> genUnitPlane(glm::vec3 &color, shaderID &shader)
@@ -55,7 +77,9 @@ namespace MeshUtil
         };
 
         // Return Mesh
-        return Mesh(vertices, indices, shader);
+        Mesh<VertexType> mesh(vertices, indices, shader);
+        mesh.bounds = computeBounds(mesh.vertices);
+        return mesh;
     };
 
     template <typename VertexType>
@@ -117,9 +141,28 @@ namespace MeshUtil
             }
         }
 
-        // Return Mesh
-        return Mesh(vertices, indices, shader);
+        // Return Mesh, the terrain shaders move every vertex to a world height of 3 * height - lod / 24
+        Mesh<VertexType> mesh(vertices, indices, shader);
+        mesh.bounds = computeBounds(mesh.vertices);
+        mesh.bounds.min.z = -lod / 24.0f;
+        mesh.bounds.max.z = 3.0f;
+        return mesh;
     }
 
     unsigned int setupSkyBoxMesh();
+
+    // Vertices in the layout the GPU reads, see GpuVertex
+    PackedVertexAnimated pack(const VertexAnimated &vertex);
+    PackedVertexSimple pack(const VertexSimple &vertex);
+    PackedVertexTextured pack(const VertexTextured &vertex);
+
+    // Vertex array binds of meshes skip the call if it is already bound
+    inline unsigned int boundVertexArray = 0;
+    inline int vertexArrayBinds = 0;
+
+    void bindVertexArray(unsigned int vertexArray);
+    void invalidateVertexArray();
+
+    // Point the instance attributes of the bound vertex array at instanceBuffer, starting at offset
+    void setupInstanceAttributes(unsigned int instanceBuffer, size_t offset);
 };
\ No newline at end of file
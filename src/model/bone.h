@@ -10,7 +10,6 @@ struct Bone
     std::string name;
     int index;
     glm::mat4 offsetMatrix;
-    glm::mat4 transform = glm::mat4(1.0f);
     Bone *parent;
     std::vector<Bone *> children;
 
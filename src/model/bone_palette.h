@@ -0,0 +1,37 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <vector>
+
+// Triple buffered bone palette of one model instance
+// The animation fills one buffer and publishes it, render prep takes the newest published one, neither waits on the other
+struct BonePalette
+{
+    std::vector<glm::mat4> buffers[3];
+
+    void resize(size_t boneCount)
+    {
+        for (auto &buffer : buffers)
+            buffer.assign(boneCount, glm::mat4(1.0f));
+    }
+
+    // Animation side
+    std::vector<glm::mat4> &write() { return buffers[writeIndex]; }
+    void publish() { writeIndex = published.exchange(writeIndex | fresh, std::memory_order_acq_rel) & indexMask; }
+
+    // Render prep side, keeps the buffer it has until something newer is published
+    const std::vector<glm::mat4> &read()
+    {
+        if (published.load(std::memory_order_acquire) & fresh)
+            readIndex = published.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+        return buffers[readIndex];
+    }
+
+private:
+    static constexpr int indexMask = 3, fresh = 4;
+
+    int writeIndex = 0, readIndex = 1;
+    std::atomic<int> published{2};
+};
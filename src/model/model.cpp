@@ -2,6 +2,8 @@
 
 #include "pch.h"
 
+#include "animation/matrix_batch.hpp"
+
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 
@@ -72,6 +74,9 @@ void Model::loadModel(std::string mainPath, std::optional<std::vector<std::strin
         processNode(scene->mRootNode, scene, shader, lodLevelMeshes, nullptr);
 
         MeshVariant combinedMesh = combineMeshVariants(lodLevelMeshes);
+        std::visit([](auto &mesh)
+                   { mesh.bounds = MeshUtil::computeBounds(mesh.vertices); },
+                   combinedMesh);
         lodMeshes.push_back({std::move(combinedMesh)});
     }
 
@@ -254,7 +259,22 @@ void Model::loadHitbox(std::optional<std::string> hitboxPath)
 
         processHitboxNode(scene->mRootNode, scene, loadMeshes);
 
+        // One hull per hitbox mesh
+        auto hulls = std::make_shared<std::vector<ConvexHull>>();
+        for (auto &meshVariant : loadMeshes)
+        {
+            auto *mesh = std::get_if<Mesh<VertexHitbox>>(&meshVariant);
+            if (!mesh)
+                continue;
+
+            std::vector<glm::vec3> points;
+            for (const auto &vertex : mesh->vertices)
+                points.push_back(vertex.Position);
+            hulls->push_back(ConvexHull::build(points));
+        }
+
         hitboxMeshes = std::move(loadMeshes);
+        hitboxHulls = std::move(hulls);
     }
     else
     {
@@ -262,18 +282,24 @@ void Model::loadHitbox(std::optional<std::string> hitboxPath)
         {
             const MeshVariant &meshVariant = lodMeshes.back().front();
 
-            std::vector<VertexHitbox> hitboxVertices;
-            std::vector<unsigned int> hitboxIndices;
-
+            std::vector<glm::vec3> points;
             std::visit([&](auto &&mesh)
                        { for (const auto &v : mesh.vertices) 
-                            hitboxVertices.push_back(VertexHitbox{v.Position});
-                        hitboxIndices = mesh.indices; },
+                            points.push_back(v.Position); },
                        meshVariant);
 
+            // Hull of the lowest LOD, the hitbox mesh only keeps the hull instead of a copy of the LOD
+            auto hulls = std::make_shared<std::vector<ConvexHull>>();
+            hulls->push_back(ConvexHull::build(points));
+
+            std::vector<VertexHitbox> hitboxVertices;
+            for (const auto &vertex : hulls->front().vertices)
+                hitboxVertices.push_back(VertexHitbox{vertex});
+
             std::vector<MeshVariant> fallbackHitboxMesh;
-            fallbackHitboxMesh.emplace_back(Mesh<VertexHitbox>(hitboxVertices, hitboxIndices, shaderID::None));
+            fallbackHitboxMesh.emplace_back(Mesh<VertexHitbox>(hitboxVertices, hulls->front().indices, shaderID::None));
             hitboxMeshes = std::move(fallbackHitboxMesh);
+            hitboxHulls = std::move(hulls);
         }
     }
 }
@@ -356,40 +382,42 @@ MeshVariant Model::combineMeshVariants(const std::vector<MeshVariant> &variants)
         return MeshVariant{std::move(combined)}; }, variants[0]);
 }
 
-const std::vector<glm::mat4> &Model::getReadBuffer()
-{
-    return boneTransforms[ModelUtil::activeBoneBuffer.load(std::memory_order_acquire)];
-}
-
-std::vector<glm::mat4> &Model::getWriteBuffer()
-{
-    return boneTransforms[1 - ModelUtil::activeBoneBuffer.load(std::memory_order_acquire)];
-}
-
 void Model::generateBoneTransforms()
 {
     // Resize if matrix array not large enough
-    for (int i = 0; i < 2; i++)
-    {
-        if (boneTransforms[i].size() != boneHierarchy.size())
-        {
-            boneTransforms[i].resize(boneHierarchy.size(), glm::mat4(1.0f));
-        }
-    }
-
     if (boneOffsets.size() != boneHierarchy.size())
         boneOffsets.resize(boneHierarchy.size(), glm::mat4(1.0f));
     if (boneInverseOffsets.size() != boneHierarchy.size())
         boneInverseOffsets.resize(boneHierarchy.size(), glm::mat4(1.0f));
 
+    boneOrder.clear();
+    boneParents.clear();
+    boneBindTransforms.clear();
+
     for (auto &rootBone : rootBones)
     {
-        // Start recursion from the root bone, with identity matrix for the root's parent transform
-        generateBoneTransformsRecursive(rootBone);
+        // Start from the root bone, roots have no parent transform
+        flattenBones(rootBone, -1);
+    }
+
+    // Bones the animation drives, looked up by name only here
+    if (modelType == ModelType::Yacht)
+    {
+        yachtBones.fork = boneIndex("Armature_Fork");
+        yachtBones.wheelFront = boneIndex("Armature_Wheel_Front");
+        yachtBones.wheelLeft = boneIndex("Armature_Wheel_Left");
+        yachtBones.wheelRight = boneIndex("Armature_Wheel_Right");
+        yachtBones.mast = boneIndex("Armature_Mast");
+        yachtBones.boom = boneIndex("Armature_Boom");
+        yachtBones.sail = boneIndex("Armature_Sail");
+        yachtBones.cam = boneIndex("Armature_Cam");
+
+        if (yachtBones.cam < 0)
+            std::cerr << "Error: Yacht " << name << " has no Armature_Cam bone" << std::endl;
     }
 }
 
-void Model::generateBoneTransformsRecursive(Bone *bone)
+void Model::flattenBones(Bone *bone, int parentIndex)
 {
     // Check if bone in range
     if (bone->index < 0 || bone->index >= boneHierarchy.size())
@@ -400,47 +428,30 @@ void Model::generateBoneTransformsRecursive(Bone *bone)
 
     boneInverseOffsets[bone->index] = glm::inverse(bone->offsetMatrix);
 
-    // Recursively update the transforms of the child bones
+    // Append after the parent, so a single forward pass sees every parent first
+    boneOrder.push_back(bone->index);
+    boneParents.push_back(parentIndex);
+    boneBindTransforms.push_back(parentIndex < 0 ? bone->offsetMatrix : boneInverseOffsets[parentIndex] * bone->offsetMatrix);
+
     for (Bone *child : bone->children)
     {
         if (!child)
         {
             continue; // Prevents null pointer access
         }
-        generateBoneTransformsRecursive(child);
+        flattenBones(child, bone->index);
     }
 }
 
-void Model::updateBoneTransforms(std::vector<glm::mat4> &targetBones)
+int Model::boneIndex(const std::string &boneName) const
 {
-    for (auto &rootBone : rootBones)
-    {
-        // Start recursion from the root bone, with identity matrix for the root's parent transform
-        updateBoneTransformsRecursive(rootBone, glm::mat4(1.0f), glm::mat4(1.0f), targetBones);
-    }
+    auto it = boneHierarchy.find(boneName);
+    return (it != boneHierarchy.end() && it->second) ? it->second->index : -1;
 }
 
-void Model::updateBoneTransformsRecursive(Bone *bone, const glm::mat4 &parentTransform, const glm::mat4 &parentInverseOffset, std::vector<glm::mat4> &targetBones)
+void Model::updateBoneTransforms(std::vector<glm::mat4> &targetBones) const
 {
-    // Check if bone in range
-    if (bone->index < 0 || bone->index >= targetBones.size())
-    {
-        std::cerr << "Error: Bone index out of range: " << bone->index << ", with name: " << bone->name << std::endl;
-        return;
-    }
-
-    // Update bone transform
-    targetBones[bone->index] = parentTransform * parentInverseOffset * bone->offsetMatrix * bone->transform;
-
-    // Recursively update the transforms of the child bones
-    for (Bone *child : bone->children)
-    {
-        if (!child)
-        {
-            continue; // Prevents null pointer access
-        }
-        updateBoneTransformsRecursive(child, targetBones[bone->index], boneInverseOffsets[bone->index], targetBones);
-    }
+    MatrixBatch::chain(boneBindTransforms.data(), boneOrder.data(), boneParents.data(), boneOrder.size(), targetBones.data());
 }
 
 void Model::uploadToGPU()
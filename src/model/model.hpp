@@ -6,9 +6,11 @@
 #include <vector>
 #include <optional>
 #include <map>
+#include <memory>
 
 #include "mesh/meshvariant.h"
 #include "model/model_defs.h"
+#include "physics/convex_hull.hpp"
 
 enum class shaderID;
 struct Bone;
@@ -18,6 +20,8 @@ class Model
 {
 public:
     Model(LoadModelData &loadModelData);
+    // Empty model, for checks that fill in meshes and bones by hand
+    Model() = default;
     ~Model();
 
     void uploadToGPU();
@@ -28,9 +32,15 @@ public:
     std::vector<glm::mat4> boneInverseOffsets;
     std::vector<Bone *> rootBones;
 
-    std::vector<glm::mat4> boneTransforms[2];
-    const std::vector<glm::mat4> &getReadBuffer();
-    std::vector<glm::mat4> &getWriteBuffer();
+    // Hierarchy flattened at load, parents before children, palette index of each bone and of its parent, -1 for roots
+    std::vector<int> boneOrder;
+    std::vector<int> boneParents;
+    // Parent inverse offset times own offset, the bind pose part of each bone's transform
+    std::vector<glm::mat4> boneBindTransforms;
+    YachtBones yachtBones;
+
+    // Palette index of a named bone, -1 if the model has none
+    int boneIndex(const std::string &name) const;
 
     std::string name;
     ModelType modelType;
@@ -40,13 +50,13 @@ public:
 
     std::vector<std::vector<MeshVariant>> lodMeshes;
     std::optional<std::vector<MeshVariant>> hitboxMeshes;
+    std::shared_ptr<const std::vector<ConvexHull>> hitboxHulls;
     std::string directory;
 
-    // Generate and update bones
+    // Generate and update bones, targetBones holds the local animation of every bone and becomes the palette in place
     void generateBoneTransforms();
-    void generateBoneTransformsRecursive(Bone *bone);
-    void updateBoneTransforms(std::vector<glm::mat4> &targetBones);
-    void updateBoneTransformsRecursive(Bone *bone, const glm::mat4 &parentTransform, const glm::mat4 &parentInverseOffset, std::vector<glm::mat4> &targetBones);
+    void flattenBones(Bone *bone, int parentIndex);
+    void updateBoneTransforms(std::vector<glm::mat4> &targetBones) const;
 
     // Draw meshes in model
     void draw(int lodIndex);
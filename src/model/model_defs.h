@@ -10,6 +10,15 @@ enum class ModelType
     Yacht
 };
 
+// Palette indices of the bones a yacht animates, resolved by name once at load, -1 when missing
+struct YachtBones
+{
+    int fork = -1;
+    int wheelFront = -1, wheelLeft = -1, wheelRight = -1;
+    int mast = -1, boom = -1, sail = -1;
+    int cam = -1;
+};
+
 struct JSONModelMapEntry
 {
     std::string mainPath;
@@ -36,9 +36,3 @@ void ModelUtil::loadModelMap()
         modelMap[name] = data;
     }
 }
-
-void ModelUtil::swapBoneBuffers()
-{
-    int oldIndex = activeBoneBuffer.load(std::memory_order_relaxed);
-    activeBoneBuffer.store(1 - oldIndex, std::memory_order_release);
-}
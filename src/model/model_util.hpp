@@ -1,6 +1,5 @@
 #pragma once
 
-#include <atomic>
 #include <string>
 #include <map>
 
@@ -8,9 +7,6 @@
 
 namespace ModelUtil
 {
-    inline std::atomic<int> activeBoneBuffer{0};
-    void swapBoneBuffers();
-
     // Model map and load function
     inline std::map<std::string, JSONModelMapEntry> modelMap;
     inline std::string modelMapPath = "resources/models.json";
@@ -42,6 +42,7 @@
 #include "model/model.hpp"
 #include "model/model_util.hpp"
 #include "physics/physics_util.hpp"
+#include "physics/telemetry.hpp"
 #include "render/render.hpp"
 #include "scene/scene.hpp"
 #include "scene_manager/scene_manager.hpp"
@@ -55,4 +56,5 @@
 #include "window_manager/window_manager.hpp"
 
 // Utilites
+#include "allocation_counter.hpp"
 #include "easing_functions.h"
\ No newline at end of file
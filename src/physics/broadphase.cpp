@@ -0,0 +1,122 @@
+#include "physics/broadphase.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void Broadphase::reset(size_t count)
+{
+    // Around four slots per entry keeps buckets short
+    size_t slotCount = 64;
+    while (slotCount < count * 4)
+        slotCount *= 2;
+
+    slots.resize(slotCount);
+    // Buckets keep room for a few entries, so bodies moving into fresh slots rarely allocate
+    for (auto &slot : slots)
+    {
+        slot.clear();
+        slot.reserve(8);
+    }
+
+    slotMask = static_cast<uint32_t>(slotCount - 1);
+    ranges.assign(count, CellRange{0, 0, -1, -1});
+    boundsMin.resize(count);
+    boundsMax.resize(count);
+}
+
+bool Broadphase::overlaps(int a, int b) const
+{
+    return boundsMin[a].x <= boundsMax[b].x && boundsMin[b].x <= boundsMax[a].x &&
+           boundsMin[a].y <= boundsMax[b].y && boundsMin[b].y <= boundsMax[a].y &&
+           boundsMin[a].z <= boundsMax[b].z && boundsMin[b].z <= boundsMax[a].z;
+}
+
+uint32_t Broadphase::slotIndex(int x, int y) const
+{
+    return (static_cast<uint32_t>(x) * 73856093u ^ static_cast<uint32_t>(y) * 19349663u) & slotMask;
+}
+
+Broadphase::CellRange Broadphase::cellRange(const glm::vec3 &min, const glm::vec3 &max) const
+{
+    float invCellSize = 1.0f / cellSize;
+    return {static_cast<int>(std::floor(min.x * invCellSize)), static_cast<int>(std::floor(min.y * invCellSize)),
+            static_cast<int>(std::floor(max.x * invCellSize)), static_cast<int>(std::floor(max.y * invCellSize))};
+}
+
+void Broadphase::insert(int entry, const CellRange &range)
+{
+    for (int y = range.minY; y <= range.maxY; y++)
+        for (int x = range.minX; x <= range.maxX; x++)
+        {
+            // Two cells of one entry can share a slot, store it once
+            auto &slot = slots[slotIndex(x, y)];
+            if (std::find(slot.begin(), slot.end(), entry) == slot.end())
+                slot.push_back(entry);
+        }
+}
+
+void Broadphase::remove(int entry, const CellRange &range)
+{
+    for (int y = range.minY; y <= range.maxY; y++)
+        for (int x = range.minX; x <= range.maxX; x++)
+        {
+            auto &slot = slots[slotIndex(x, y)];
+            auto it = std::find(slot.begin(), slot.end(), entry);
+            if (it != slot.end())
+            {
+                *it = slot.back();
+                slot.pop_back();
+            }
+        }
+}
+
+void Broadphase::update(const glm::vec3 *centers, const float *radii, size_t count)
+{
+    if (count != ranges.size())
+        reset(count);
+
+    // Move entries whose cells changed, most entries stay put between ticks
+    for (size_t i = 0; i < count; i++)
+    {
+        boundsMin[i] = centers[i] - glm::vec3(radii[i]);
+        boundsMax[i] = centers[i] + glm::vec3(radii[i]);
+
+        CellRange range = cellRange(boundsMin[i], boundsMax[i]);
+        if (range == ranges[i])
+            continue;
+
+        remove(static_cast<int>(i), ranges[i]);
+        insert(static_cast<int>(i), range);
+        ranges[i] = range;
+    }
+
+    pairs.clear();
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const int a = static_cast<int>(i);
+        const CellRange &range = ranges[i];
+
+        for (int y = range.minY; y <= range.maxY; y++)
+            for (int x = range.minX; x <= range.maxX; x++)
+            {
+                for (int b : slots[slotIndex(x, y)])
+                {
+                    if (b <= a)
+                        continue;
+
+                    // Full bounds test, also rejects entries from other cells in the same slot
+                    if (!overlaps(a, b))
+                        continue;
+
+                    // Report the pair only from the cell holding the corner of the overlap
+                    glm::vec3 overlapMin = glm::max(boundsMin[a], boundsMin[b]);
+                    CellRange corner = cellRange(overlapMin, overlapMin);
+                    if (corner.minX != x || corner.minY != y)
+                        continue;
+
+                    pairs.push_back({a, b});
+                }
+            }
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+
+// Candidate pair of collision slots, a < b
+struct CollisionPair
+{
+    int a, b;
+};
+
+// Spatial hash over the ground plane with a fixed table, cells that share a slot only cost extra overlap tests
+class Broadphase
+{
+public:
+    void setCellSize(float size) { cellSize = size; ranges.clear(); }
+    float getCellSize() const { return cellSize; }
+
+    // Update from bounding spheres, only entries that changed cells are moved
+    void update(const glm::vec3 *centers, const float *radii, size_t count);
+
+    // Overlapping bounds found by the last update, indices into the arrays given to update
+    const std::vector<CollisionPair> &getPairs() const { return pairs; }
+
+private:
+    struct CellRange
+    {
+        int minX, minY, maxX, maxY;
+        bool operator==(const CellRange &other) const
+        {
+            return minX == other.minX && minY == other.minY && maxX == other.maxX && maxY == other.maxY;
+        }
+    };
+
+    float cellSize = 8.0f;
+    uint32_t slotMask = 0;
+
+    std::vector<std::vector<int>> slots;
+    std::vector<CellRange> ranges;
+    std::vector<glm::vec3> boundsMin;
+    std::vector<glm::vec3> boundsMax;
+    std::vector<CollisionPair> pairs;
+
+    void reset(size_t count);
+    bool overlaps(int a, int b) const;
+    uint32_t slotIndex(int x, int y) const;
+    CellRange cellRange(const glm::vec3 &min, const glm::vec3 &max) const;
+    void insert(int entry, const CellRange &range);
+    void remove(int entry, const CellRange &range);
+};
@@ -0,0 +1,310 @@
+#include "physics/convex_hull.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+
+namespace
+{
+    struct HullFace
+    {
+        int v[3];
+        glm::vec3 normal;
+        float offset;
+        bool removed = false;
+    };
+
+    HullFace makeFace(const std::vector<glm::vec3> &points, int a, int b, int c)
+    {
+        HullFace face;
+        face.v[0] = a;
+        face.v[1] = b;
+        face.v[2] = c;
+        face.normal = glm::normalize(glm::cross(points[b] - points[a], points[c] - points[a]));
+        face.offset = glm::dot(face.normal, points[a]);
+        return face;
+    }
+
+    uint64_t edgeKey(int a, int b)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 32) | static_cast<uint32_t>(b);
+    }
+
+    // Flat or degenerate clouds keep every point and no adjacency
+    ConvexHull flatHull(const std::vector<glm::vec3> &points)
+    {
+        ConvexHull hull;
+        hull.vertices = points;
+        return hull;
+    }
+}
+
+ConvexHull ConvexHull::build(const std::vector<glm::vec3> &points)
+{
+    if (points.size() < 4)
+        return flatHull(points);
+
+    // Tolerance relative to the size of the cloud
+    glm::vec3 min = points[0], max = points[0];
+    for (const auto &point : points)
+    {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+    const float epsilon = 1e-5f * std::max(glm::length(max - min), 1e-6f);
+
+    // Initial tetrahedron from extreme points
+    int i0 = 0, i1 = 0;
+    for (int i = 0; i < static_cast<int>(points.size()); i++)
+    {
+        if (points[i].x < points[i0].x)
+            i0 = i;
+        if (points[i].x > points[i1].x)
+            i1 = i;
+    }
+    if (glm::length(points[i1] - points[i0]) <= epsilon)
+        return flatHull(points);
+
+    int i2 = -1;
+    float best = epsilon;
+    glm::vec3 lineDir = glm::normalize(points[i1] - points[i0]);
+    for (int i = 0; i < static_cast<int>(points.size()); i++)
+    {
+        glm::vec3 offset = points[i] - points[i0];
+        float distance = glm::length(offset - glm::dot(offset, lineDir) * lineDir);
+        if (distance > best)
+        {
+            best = distance;
+            i2 = i;
+        }
+    }
+    if (i2 < 0)
+        return flatHull(points);
+
+    int i3 = -1;
+    best = epsilon;
+    glm::vec3 planeNormal = glm::normalize(glm::cross(points[i1] - points[i0], points[i2] - points[i0]));
+    for (int i = 0; i < static_cast<int>(points.size()); i++)
+    {
+        float distance = std::fabs(glm::dot(points[i] - points[i0], planeNormal));
+        if (distance > best)
+        {
+            best = distance;
+            i3 = i;
+        }
+    }
+    if (i3 < 0)
+        return flatHull(points);
+
+    // Orient faces outwards
+    if (glm::dot(points[i3] - points[i0], planeNormal) > 0.0f)
+        std::swap(i1, i2);
+
+    std::vector<HullFace> faces;
+
+    // Directed edge to the face it belongs to, the twin of edge (a, b) is (b, a)
+    std::unordered_map<uint64_t, int> edgeFace;
+    auto addFace = [&](int a, int b, int c)
+    {
+        int f = static_cast<int>(faces.size());
+        faces.push_back(makeFace(points, a, b, c));
+        edgeFace[edgeKey(a, b)] = f;
+        edgeFace[edgeKey(b, c)] = f;
+        edgeFace[edgeKey(c, a)] = f;
+    };
+
+    addFace(i0, i1, i2);
+    addFace(i0, i3, i1);
+    addFace(i1, i3, i2);
+    addFace(i2, i3, i0);
+
+    // Furthest points first, most of the rest then ends up inside and is skipped
+    glm::vec3 center = (points[i0] + points[i1] + points[i2] + points[i3]) * 0.25f;
+    std::vector<int> order;
+    for (int i = 0; i < static_cast<int>(points.size()); i++)
+        if (i != i0 && i != i1 && i != i2 && i != i3)
+            order.push_back(i);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b)
+                     { return glm::dot(points[a] - center, points[a] - center) > glm::dot(points[b] - center, points[b] - center); });
+
+    std::vector<int> liveFaces = {0, 1, 2, 3};
+    std::vector<int> checked, visibleMark;
+    std::vector<int> stack, visible;
+    std::vector<std::pair<int, int>> horizon;
+    size_t removedCount = 0;
+
+    // Grow the hull one point at a time
+    for (int p : order)
+    {
+        int bestFace = -1;
+        float bestDistance = epsilon;
+        for (int f : liveFaces)
+        {
+            float distance = glm::dot(faces[f].normal, points[p]) - faces[f].offset;
+            if (!faces[f].removed && distance > bestDistance)
+            {
+                bestDistance = distance;
+                bestFace = f;
+            }
+        }
+
+        if (bestFace < 0)
+            continue;
+
+        // Flood the visible faces from the most visible one, so they stay connected
+        checked.resize(faces.size(), -1);
+        visibleMark.resize(faces.size(), -1);
+        checked[bestFace] = p;
+        visibleMark[bestFace] = p;
+        stack.assign(1, bestFace);
+        visible.clear();
+        horizon.clear();
+
+        while (!stack.empty())
+        {
+            int f = stack.back();
+            stack.pop_back();
+            visible.push_back(f);
+
+            for (int e = 0; e < 3; e++)
+            {
+                int a = faces[f].v[e];
+                int b = faces[f].v[(e + 1) % 3];
+                auto twinIt = edgeFace.find(edgeKey(b, a));
+                if (twinIt == edgeFace.end())
+                {
+                    horizon.push_back({a, b});
+                    continue;
+                }
+                int twin = twinIt->second;
+
+                if (checked[twin] != p)
+                {
+                    checked[twin] = p;
+                    if (glm::dot(faces[twin].normal, points[p]) - faces[twin].offset > epsilon)
+                    {
+                        visibleMark[twin] = p;
+                        stack.push_back(twin);
+                    }
+                }
+
+                // Horizon edges border exactly one visible face
+                if (visibleMark[twin] != p)
+                    horizon.push_back({a, b});
+            }
+        }
+
+        for (int f : visible)
+        {
+            faces[f].removed = true;
+            for (int e = 0; e < 3; e++)
+                edgeFace.erase(edgeKey(faces[f].v[e], faces[f].v[(e + 1) % 3]));
+        }
+        removedCount += visible.size();
+
+        for (const auto &[a, b] : horizon)
+        {
+            liveFaces.push_back(static_cast<int>(faces.size()));
+            addFace(a, b, p);
+        }
+
+        // Drop removed faces once they make up half the list to keep the scan short
+        if (removedCount * 2 > liveFaces.size())
+        {
+            liveFaces.erase(std::remove_if(liveFaces.begin(), liveFaces.end(), [&](int f)
+                                           { return faces[f].removed; }),
+                            liveFaces.end());
+            removedCount = 0;
+        }
+    }
+
+    // Compact to hull vertices only
+    ConvexHull hull;
+    std::vector<int> remap(points.size(), -1);
+
+    for (const auto &face : faces)
+    {
+        if (face.removed)
+            continue;
+        for (int v : face.v)
+        {
+            if (remap[v] < 0)
+            {
+                remap[v] = static_cast<int>(hull.vertices.size());
+                hull.vertices.push_back(points[v]);
+            }
+            hull.indices.push_back(remap[v]);
+        }
+    }
+
+    // Vertex adjacency from triangle edges
+    std::vector<std::vector<int>> neighbours(hull.vertices.size());
+    for (size_t t = 0; t < hull.indices.size(); t += 3)
+        for (int e = 0; e < 3; e++)
+        {
+            int a = hull.indices[t + e];
+            int b = hull.indices[t + (e + 1) % 3];
+            neighbours[a].push_back(b);
+            neighbours[b].push_back(a);
+        }
+
+    hull.adjacencyOffset.push_back(0);
+    for (auto &list : neighbours)
+    {
+        std::sort(list.begin(), list.end());
+        list.erase(std::unique(list.begin(), list.end()), list.end());
+        hull.adjacency.insert(hull.adjacency.end(), list.begin(), list.end());
+        hull.adjacencyOffset.push_back(static_cast<int>(hull.adjacency.size()));
+    }
+
+    return hull;
+}
+
+int ConvexHull::support(const glm::vec3 &direction, int start) const
+{
+    if (adjacency.empty())
+        return supportLinear(direction);
+
+    int current = (start >= 0 && start < static_cast<int>(vertices.size())) ? start : 0;
+    float currentDot = glm::dot(vertices[current], direction);
+
+    // Move to the best neighbour until none is better, a local maximum on a convex hull is global
+    for (size_t steps = 0; steps < vertices.size(); steps++)
+    {
+        int next = current;
+        for (int n = adjacencyOffset[current]; n < adjacencyOffset[current + 1]; n++)
+        {
+            float dot = glm::dot(vertices[adjacency[n]], direction);
+            if (dot > currentDot)
+            {
+                currentDot = dot;
+                next = adjacency[n];
+            }
+        }
+        if (next == current)
+            break;
+        current = next;
+    }
+
+    return current;
+}
+
+int ConvexHull::supportLinear(const glm::vec3 &direction) const
+{
+    int best = 0;
+    float bestDot = -std::numeric_limits<float>::infinity();
+
+    for (int i = 0; i < static_cast<int>(vertices.size()); i++)
+    {
+        float dot = glm::dot(vertices[i], direction);
+        if (dot > bestDot)
+        {
+            bestDot = dot;
+            best = i;
+        }
+    }
+
+    return best;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// Convex hull of a point cloud with vertex adjacency, built once at load
+struct ConvexHull
+{
+    std::vector<glm::vec3> vertices;
+    std::vector<unsigned int> indices;
+
+    // Neighbours of vertex i are adjacency[adjacencyOffset[i]] up to adjacency[adjacencyOffset[i + 1]]
+    std::vector<int> adjacencyOffset;
+    std::vector<int> adjacency;
+
+    static ConvexHull build(const std::vector<glm::vec3> &points);
+
+    // Index of the vertex furthest along direction, climbing from start
+    int support(const glm::vec3 &direction, int start = 0) const;
+
+    // Linear scan, used when the hull is flat and has no adjacency
+    int supportLinear(const glm::vec3 &direction) const;
+};
@@ -0,0 +1,368 @@
+#include "physics/narrowphase.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr int maxGjkIterations = 32;
+    constexpr int maxEpaIterations = 32;
+    constexpr int maxEpaVertices = 4 + maxEpaIterations;
+    constexpr int maxEpaFaces = 128;
+    constexpr int maxEpaEdges = 128;
+    constexpr float epaTolerance = 1e-4f;
+
+    // Point on the Minkowski difference A - B, with the points on A and B that made it
+    struct SupportPoint
+    {
+        glm::vec3 v, a, b;
+    };
+
+    SupportPoint support(CollisionShape &a, CollisionShape &b, const glm::vec3 &direction)
+    {
+        SupportPoint point;
+        point.a = a.support(direction);
+        point.b = b.support(-direction);
+        point.v = point.a - point.b;
+        return point;
+    }
+
+    bool sameDirection(const glm::vec3 &a, const glm::vec3 &b)
+    {
+        return glm::dot(a, b) > 0.0f;
+    }
+
+    // Simplex with the newest point first
+    struct Simplex
+    {
+        SupportPoint points[4];
+        int size = 0;
+
+        void pushFront(const SupportPoint &point)
+        {
+            for (int i = std::min(size, 3); i > 0; i--)
+                points[i] = points[i - 1];
+            points[0] = point;
+            size = std::min(size + 1, 4);
+        }
+
+        void set(const SupportPoint &p0)
+        {
+            points[0] = p0;
+            size = 1;
+        }
+
+        void set(const SupportPoint &p0, const SupportPoint &p1)
+        {
+            points[0] = p0;
+            points[1] = p1;
+            size = 2;
+        }
+
+        void set(const SupportPoint &p0, const SupportPoint &p1, const SupportPoint &p2)
+        {
+            points[0] = p0;
+            points[1] = p1;
+            points[2] = p2;
+            size = 3;
+        }
+    };
+
+    bool line(Simplex &simplex, glm::vec3 &direction)
+    {
+        SupportPoint a = simplex.points[0], b = simplex.points[1];
+        glm::vec3 ab = b.v - a.v, ao = -a.v;
+
+        if (sameDirection(ab, ao))
+            direction = glm::cross(glm::cross(ab, ao), ab);
+        else
+        {
+            simplex.set(a);
+            direction = ao;
+        }
+        return false;
+    }
+
+    bool triangle(Simplex &simplex, glm::vec3 &direction)
+    {
+        SupportPoint a = simplex.points[0], b = simplex.points[1], c = simplex.points[2];
+        glm::vec3 ab = b.v - a.v, ac = c.v - a.v, ao = -a.v;
+        glm::vec3 abc = glm::cross(ab, ac);
+
+        if (sameDirection(glm::cross(abc, ac), ao))
+        {
+            if (sameDirection(ac, ao))
+            {
+                simplex.set(a, c);
+                direction = glm::cross(glm::cross(ac, ao), ac);
+            }
+            else
+            {
+                simplex.set(a, b);
+                return line(simplex, direction);
+            }
+        }
+        else if (sameDirection(glm::cross(ab, abc), ao))
+        {
+            simplex.set(a, b);
+            return line(simplex, direction);
+        }
+        else if (sameDirection(abc, ao))
+            direction = abc;
+        else
+        {
+            simplex.set(a, c, b);
+            direction = -abc;
+        }
+        return false;
+    }
+
+    bool tetrahedron(Simplex &simplex, glm::vec3 &direction)
+    {
+        SupportPoint a = simplex.points[0], b = simplex.points[1], c = simplex.points[2], d = simplex.points[3];
+        glm::vec3 ab = b.v - a.v, ac = c.v - a.v, ad = d.v - a.v, ao = -a.v;
+
+        if (sameDirection(glm::cross(ab, ac), ao))
+        {
+            simplex.set(a, b, c);
+            return triangle(simplex, direction);
+        }
+        if (sameDirection(glm::cross(ac, ad), ao))
+        {
+            simplex.set(a, c, d);
+            return triangle(simplex, direction);
+        }
+        if (sameDirection(glm::cross(ad, ab), ao))
+        {
+            simplex.set(a, d, b);
+            return triangle(simplex, direction);
+        }
+        return true;
+    }
+
+    bool nextSimplex(Simplex &simplex, glm::vec3 &direction)
+    {
+        switch (simplex.size)
+        {
+        case 2:
+            return line(simplex, direction);
+        case 3:
+            return triangle(simplex, direction);
+        case 4:
+            return tetrahedron(simplex, direction);
+        }
+        return false;
+    }
+
+    struct EpaFace
+    {
+        int v[3];
+        glm::vec3 normal;
+        float distance;
+    };
+
+    // Outward normal and distance to the origin, the winding is flipped if the face points inwards
+    bool makeFace(const SupportPoint *vertices, int a, int b, int c, EpaFace &face)
+    {
+        glm::vec3 normal = glm::cross(vertices[b].v - vertices[a].v, vertices[c].v - vertices[a].v);
+        float length = glm::length(normal);
+        if (length < 1e-12f)
+            return false;
+
+        normal /= length;
+        float distance = glm::dot(normal, vertices[a].v);
+        if (distance < 0.0f)
+        {
+            std::swap(b, c);
+            normal = -normal;
+            distance = -distance;
+        }
+
+        face = {{a, b, c}, normal, distance};
+        return true;
+    }
+
+    // Expand the polytope towards the face closest to the origin until it is on the hull of A - B
+    void epa(CollisionShape &a, CollisionShape &b, const Simplex &simplex, Contact &contact)
+    {
+        SupportPoint vertices[maxEpaVertices];
+        EpaFace faces[maxEpaFaces];
+        int edges[maxEpaEdges][2];
+        int vertexCount = 4, faceCount = 0;
+
+        for (int i = 0; i < 4; i++)
+            vertices[i] = simplex.points[i];
+
+        const int initial[4][3] = {{0, 1, 2}, {0, 3, 1}, {0, 2, 3}, {1, 3, 2}};
+        for (const auto &f : initial)
+            if (makeFace(vertices, f[0], f[1], f[2], faces[faceCount]))
+                faceCount++;
+
+        int closest = -1;
+        for (int iteration = 0; iteration < maxEpaIterations && faceCount > 0; iteration++)
+        {
+            closest = 0;
+            for (int f = 1; f < faceCount; f++)
+                if (faces[f].distance < faces[closest].distance)
+                    closest = f;
+
+            const EpaFace face = faces[closest];
+            SupportPoint point = support(a, b, face.normal);
+            if (glm::dot(face.normal, point.v) - face.distance < epaTolerance || vertexCount == maxEpaVertices)
+                break;
+
+            // A point already on the polytope means it can not grow further, flat hulls give many of these
+            bool known = false;
+            for (int v = 0; v < vertexCount && !known; v++)
+                known = glm::dot(vertices[v].v - point.v, vertices[v].v - point.v) < epaTolerance * epaTolerance;
+            if (known)
+                break;
+
+            // Remove faces the new point sees, keeping their boundary edges
+            int edgeCount = 0;
+            bool overflow = false;
+            for (int f = 0; f < faceCount;)
+            {
+                // The tolerance keeps faces coplanar with the new point, the closest face is always seen
+                if (glm::dot(faces[f].normal, point.v - vertices[faces[f].v[0]].v) < 0.5f * epaTolerance)
+                {
+                    f++;
+                    continue;
+                }
+
+                for (int e = 0; e < 3; e++)
+                {
+                    int v0 = faces[f].v[e], v1 = faces[f].v[(e + 1) % 3];
+
+                    // An edge shared by two removed faces is not on the boundary
+                    bool shared = false;
+                    for (int k = 0; k < edgeCount; k++)
+                        if (edges[k][0] == v1 && edges[k][1] == v0)
+                        {
+                            edges[k][0] = edges[edgeCount - 1][0];
+                            edges[k][1] = edges[edgeCount - 1][1];
+                            edgeCount--;
+                            shared = true;
+                            break;
+                        }
+
+                    if (!shared)
+                    {
+                        if (edgeCount == maxEpaEdges)
+                        {
+                            overflow = true;
+                            break;
+                        }
+                        edges[edgeCount][0] = v0;
+                        edges[edgeCount][1] = v1;
+                        edgeCount++;
+                    }
+                }
+
+                faces[f] = faces[--faceCount];
+            }
+
+            if (overflow || faceCount + edgeCount > maxEpaFaces)
+            {
+                closest = -1;
+                break;
+            }
+
+            int newVertex = vertexCount++;
+            vertices[newVertex] = point;
+            for (int e = 0; e < edgeCount; e++)
+                if (makeFace(vertices, edges[e][0], edges[e][1], newVertex, faces[faceCount]))
+                    faceCount++;
+
+            closest = -1;
+        }
+
+        if (closest < 0)
+        {
+            if (faceCount == 0)
+                return;
+
+            closest = 0;
+            for (int f = 1; f < faceCount; f++)
+                if (faces[f].distance < faces[closest].distance)
+                    closest = f;
+        }
+
+        const EpaFace &face = faces[closest];
+        contact.normal = face.normal;
+        contact.depth = face.distance;
+
+        // Barycentric coordinates of the origin projected on the closest face give the contact points
+        const SupportPoint &p0 = vertices[face.v[0]], &p1 = vertices[face.v[1]], &p2 = vertices[face.v[2]];
+        glm::vec3 p = face.normal * face.distance;
+        glm::vec3 v0 = p1.v - p0.v, v1 = p2.v - p0.v, v2 = p - p0.v;
+        float d00 = glm::dot(v0, v0), d01 = glm::dot(v0, v1), d11 = glm::dot(v1, v1);
+        float d20 = glm::dot(v2, v0), d21 = glm::dot(v2, v1);
+        float denom = d00 * d11 - d01 * d01;
+
+        float v = 0.0f, w = 0.0f;
+        if (std::fabs(denom) > 1e-12f)
+        {
+            v = (d11 * d20 - d01 * d21) / denom;
+            w = (d00 * d21 - d01 * d20) / denom;
+        }
+        float u = 1.0f - v - w;
+
+        contact.pointA = u * p0.a + v * p1.a + w * p2.a;
+        contact.pointB = u * p0.b + v * p1.b + w * p2.b;
+    }
+}
+
+glm::vec3 CollisionShape::support(const glm::vec3 &direction)
+{
+    lastSupport = hull->support(glm::conjugate(rot) * direction, lastSupport);
+    return pos + rot * hull->vertices[lastSupport];
+}
+
+bool Narrowphase::collide(CollisionShape &a, CollisionShape &b, glm::vec3 &axis, Contact &contact)
+{
+    if (!a.hull || !b.hull || a.hull->vertices.empty() || b.hull->vertices.empty())
+        return false;
+
+    glm::vec3 direction = glm::dot(axis, axis) > 1e-12f ? axis : b.pos - a.pos;
+    if (glm::dot(direction, direction) < 1e-12f)
+        direction = glm::vec3(1.0f, 0.0f, 0.0f);
+
+    Simplex simplex;
+    SupportPoint point = support(a, b, direction);
+
+    // Last tick's separating axis usually still separates, then this is the only query
+    if (glm::dot(point.v, direction) < 0.0f)
+    {
+        axis = direction;
+        return false;
+    }
+
+    simplex.pushFront(point);
+    direction = -point.v;
+
+    for (int iteration = 0; iteration < maxGjkIterations; iteration++)
+    {
+        // Origin on the simplex, the shapes only touch
+        if (glm::dot(direction, direction) < 1e-12f)
+            return false;
+
+        point = support(a, b, direction);
+        if (glm::dot(point.v, direction) < 0.0f)
+        {
+            axis = direction;
+            return false;
+        }
+
+        simplex.pushFront(point);
+        if (nextSimplex(simplex, direction))
+        {
+            contact = Contact();
+            epa(a, b, simplex, contact);
+            axis = contact.normal;
+            return contact.depth > 0.0f;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "physics/convex_hull.hpp"
+
+// Convex hull placed in the world, support queries climb from the last result
+struct CollisionShape
+{
+    const ConvexHull *hull = nullptr;
+    glm::vec3 pos = glm::vec3(0.0f);
+    glm::quat rot = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    int lastSupport = 0;
+
+    glm::vec3 support(const glm::vec3 &direction);
+};
+
+// Normal points from A to B, moving A by -normal * depth or B by +normal * depth separates them
+struct Contact
+{
+    glm::vec3 normal = glm::vec3(0.0f, 0.0f, 1.0f);
+    float depth = 0.0f;
+    glm::vec3 pointA = glm::vec3(0.0f);
+    glm::vec3 pointB = glm::vec3(0.0f);
+};
+
+namespace Narrowphase
+{
+    // GJK intersection test, then EPA for the penetration if the shapes overlap
+    // axis is the warm start direction, on a miss it holds the separating axis for the next tick
+    bool collide(CollisionShape &a, CollisionShape &b, glm::vec3 &axis, Contact &contact);
+};
@@ -4,8 +4,17 @@
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
+
+#include "physics/convex_hull.hpp"
+
+class WindField;
 
 struct YachtPhysicsPreset
 {
@@ -67,68 +76,155 @@ static const std::unordered_map<std::string, YachtPhysicsPreset> yachtPresets =
                 }},
 };
 
-struct BaseVariables
+// Lift and drag coefficients against angle of attack in [-pi, pi], built once per sail preset
+// Each bin keeps its own end values, so the stall at +-90 degrees, which falls on a bin edge, stays sharp
+struct SailCoefficientTable
 {
-    glm::vec3 pos;
-    glm::vec3 prevPos;
+    static constexpr int size = 512;
+
+    float maxLiftCoefficient = 0.0f;
+    float minDragCoefficient = 0.0f;
+    float optimalAngle = 1.0f;
+
+    float CL[size][2];
+    float CD[size][2];
+
+    static float lift(float angle, float maxLift, float optimal)
+    {
+        // Linear up to the optimal angle, then falling off until the sail stalls
+        if (std::fabs(angle) <= optimal)
+            return maxLift * (angle / optimal);
+        else if (std::fabs(angle) < 0.5f * 3.14159265358979f)
+            return maxLift * (optimal / std::fabs(angle)) * (angle > 0 ? 1.0f : -1.0f);
+        return 0.0f;
+    }
+
+    void build(float maxLift, float minDrag, float optimal)
+    {
+        maxLiftCoefficient = maxLift;
+        minDragCoefficient = minDrag;
+        optimalAngle = optimal;
 
-    glm::vec3 vel = glm::vec3(0.0f);
-    glm::vec3 acc = glm::vec3(0.0f);
+        const float pi = 3.14159265358979f;
+        const float step = 2.0f * pi / size;
+        const float inset = 1e-4f * step;
 
-    float mass = 1.0f;
+        for (int i = 0; i < size; i++)
+        {
+            float start = -pi + step * i + inset;
+            float end = -pi + step * (i + 1) - inset;
 
-    glm::vec3 netForce;
+            CL[i][0] = lift(start, maxLift, optimal);
+            CL[i][1] = lift(end, maxLift, optimal);
+            CD[i][0] = minDrag + std::sin(start) * std::sin(start);
+            CD[i][1] = minDrag + std::sin(end) * std::sin(end);
+        }
+    }
 
-    glm::quat rot;
-    glm::quat prevRot;
+    void lookup(float angleAttack, float &lift, float &drag) const
+    {
+        const float scale = size / (2.0f * 3.14159265358979f);
+        float t = std::clamp((angleAttack + 3.14159265358979f) * scale, 0.0f, static_cast<float>(size));
+        int i = std::min(static_cast<int>(t), size - 1);
+        float f = t - i;
+
+        lift = CL[i][0] + f * (CL[i][1] - CL[i][0]);
+        drag = CD[i][0] + f * (CD[i][1] - CD[i][0]);
+    }
 };
 
-struct BodyVariables
+// Per-body state, one contiguous array per field indexed by body
+struct BaseVariables
 {
-    float dragCoefficient;
-    float area;
+    std::vector<glm::vec3> pos;
+    std::vector<glm::vec3> prevPos;
+
+    std::vector<glm::vec3> vel;
+    std::vector<glm::vec3> acc;
+    std::vector<glm::vec3> netForce;
+
+    std::vector<glm::quat> rot;
+    std::vector<glm::quat> prevRot;
+
+    std::vector<uint8_t> onGround;
 };
 
+// Per-sail state, indexed by sail slot
 struct SailVariables
 {
-    float area;
-    float maxLiftCoefficient;
-    float minDragCoefficient;
+    std::vector<float> controlFactor;
 
-    float maxMastAngle;
-    float maxBoomAngle;
-    float optimalAngle;
+    std::vector<float> MastAngle, prevMastAngle;
+    std::vector<float> BoomAngle, prevBoomAngle;
+    std::vector<float> SailAngle, prevSailAngle;
+};
 
-    float controlFactor = 1.0f;
+// Per-driving state, indexed by driving slot
+struct DrivingVariables
+{
+    std::vector<float> steeringChange;
 
-    float MastAngle = 0.0f, prevMastAngle;
-    float BoomAngle = 0.0f, prevBoomAngle;
-    float SailAngle = 0.0f, prevSailAngle;
+    std::vector<float> steeringAngle, prevSteeringAngle;
+    std::vector<float> wheelAngle, prevWheelAngle;
 };
 
-struct DrivingVariables
+// Everything that changes during a tick, double buffered by the world
+struct PhysicsState
+{
+    BaseVariables base;
+    SailVariables sail;
+    DrivingVariables driving;
+};
+
+// Constant properties, filled once when a body is added
+struct BaseProperties
+{
+    std::vector<float> mass;
+    std::vector<uint8_t> applyGravity;
+};
+
+struct BodyProperties
+{
+    std::vector<int> body;
+    std::vector<float> dragCoefficient;
+    std::vector<float> area;
+};
+
+struct SailProperties
 {
-    float steeringSmoothness;
-    float maxSteeringAngle;
-    float steeringAttenuation;
-    float steeringChange;
+    std::vector<int> body;
+    std::vector<float> area;
 
-    float steeringAngle = 0.0f, prevSteeringAngle;
-    float wheelAngle = 0.0f, prevWheelAngle;
+    std::vector<float> maxMastAngle;
+    std::vector<float> maxBoomAngle;
 
-    float rollCoefficient;
-    float rollScaling;
+    // Coefficient table per slot, sails with the same coefficients share one
+    std::vector<int> table;
+    std::vector<SailCoefficientTable> tables;
 };
 
-struct CollisionVariables
+struct DrivingProperties
 {
+    std::vector<int> body;
+    std::vector<float> steeringSmoothness;
+    std::vector<float> maxSteeringAngle;
+    std::vector<float> steeringAttenuation;
+
+    std::vector<float> rollCoefficient;
+    std::vector<float> rollScaling;
 };
 
-struct DebugForce
+// Hitbox hulls are shared between all bodies of the same model
+struct CollisionProperties
 {
-    glm::vec3 position;
-    glm::vec3 force;
-    std::string label;
+    std::vector<int> body;
+    std::vector<std::shared_ptr<const std::vector<ConvexHull>>> hulls;
+
+    // First warm start vertex of each body, one per hull
+    std::vector<int> supportOffset;
+
+    // Bounding sphere around the body origin, used by the broadphase
+    std::vector<float> radius;
 };
 
 enum class PhysicsType
@@ -138,4 +234,55 @@ enum class PhysicsType
     Sail,
     Gravity,
     Collision
-};
\ No newline at end of file
+};
+
+// Input snapshot for the controlled body, sampled once per tick
+struct PhysicsInputs
+{
+    bool controller = false;
+    bool keys[6] = {};
+    glm::vec2 stick = glm::vec2(0.0f);
+    bool buttonA = false;
+    bool buttonB = false;
+};
+
+// Everything a tick needs from outside the world
+struct PhysicsEnvironment
+{
+    float tickTime = 1.0f / 30.0f;
+    glm::vec3 windDirection = glm::vec3(0.0f, 1.0f, 0.0f);
+    float windStrength = 10.0f;
+    float airDensity = 1.225f;
+    float g = 9.80665f;
+
+    // Sampled per sail when set, otherwise the wind above is used everywhere
+    const WindField *windField = nullptr;
+
+    int controlledBody = -1;
+    PhysicsInputs inputs;
+};
+
+// Debug values of the controlled body from the last tick
+struct PhysicsDebug
+{
+    float apparentWind = 0.0f;
+    float angleToWind = 0.0f;
+    float angleAttack = 0.0f;
+    float CL = 0.0f;
+    float CD = 0.0f;
+    float steeringAngle = 0.0f;
+    float effectiveSteeringAngle = 0.0f;
+    float velocity = 0.0f;
+    float acceleration = 0.0f;
+    bool hasSail = false;
+    bool hasDriving = false;
+};
+
+// Description of a single body, used to add it to a world
+struct PhysicsBodyDesc
+{
+    std::vector<PhysicsType> types;
+    const YachtPhysicsPreset *preset = nullptr;
+    glm::mat4 transform = glm::mat4(1.0f);
+    std::shared_ptr<const std::vector<ConvexHull>> hitboxHulls;
+};
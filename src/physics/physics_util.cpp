@@ -2,6 +2,23 @@
 
 #include "pch.h"
 
+namespace
+{
+    // Overlay keys, interned before the physics thread starts
+    const struct
+    {
+        Telemetry::Key apparentWind = Telemetry::intern("apparantWind");
+        Telemetry::Key angleToWind = Telemetry::intern("angleToWind");
+        Telemetry::Key angleAttack = Telemetry::intern("angleAttack");
+        Telemetry::Key CL = Telemetry::intern("CL");
+        Telemetry::Key CD = Telemetry::intern("CD");
+        Telemetry::Key steeringAngle = Telemetry::intern("steeringAngle");
+        Telemetry::Key effectiveSteeringAngle = Telemetry::intern("effectiveSteeringAngle");
+        Telemetry::Key velocity = Telemetry::intern("velocity");
+        Telemetry::Key acceleration = Telemetry::intern("acceleration");
+    } telemetryKeys;
+}
+
 void PhysicsUtil::update()
 {
     atomicAdd(accumulator, TimeManager::deltaTime);
@@ -32,36 +49,118 @@ void PhysicsUtil::update()
     ThreadManager::animationAlpha.store(alpha, std::memory_order_release);
 }
 
-void PhysicsUtil::stepPhysics(ModelData &model)
+void PhysicsUtil::stepPhysics(PhysicsWorld &world, WorkerPool *pool)
 {
-    auto *read = model.physics->getReadBuffer();
-    auto *write = model.physics->getWriteBuffer();
+    PhysicsEnvironment env = getEnvironment();
+
+    if (pool)
+        world.step(env, *pool);
+    else
+        world.step(env);
+
+    if (env.controlledBody < 0 || !Telemetry::physics.enabled.load(std::memory_order_relaxed))
+        return;
+
+    Telemetry::Frame *frame = Telemetry::physics.beginFrame();
+    if (!frame)
+        return;
+
+    // Debug values of controlled yacht
+    const PhysicsDebug &debug = world.debug;
 
-    write->update(model);
+    if (debug.hasSail)
+    {
+        frame->push(telemetryKeys.apparentWind, debug.apparentWind);
+        frame->push(telemetryKeys.angleToWind, debug.angleToWind);
+        frame->push(telemetryKeys.angleAttack, debug.angleAttack);
+        frame->push(telemetryKeys.CL, debug.CL);
+        frame->push(telemetryKeys.CD, debug.CD);
+    }
 
-    if (write->onGround)
+    if (debug.hasDriving)
     {
-        read->base.pos = write->base.pos;
-        read->base.vel = write->base.vel;
+        frame->push(telemetryKeys.steeringAngle, debug.steeringAngle);
+        frame->push(telemetryKeys.effectiveSteeringAngle, debug.effectiveSteeringAngle);
     }
+
+    frame->push(telemetryKeys.velocity, debug.velocity);
+    frame->push(telemetryKeys.acceleration, debug.acceleration);
+
+    Telemetry::physics.commitFrame();
+}
+
+PhysicsEnvironment PhysicsUtil::getEnvironment()
+{
+    PhysicsEnvironment env;
+
+    env.tickTime = 1 / SettingsManager::settings.physics.tickRate;
+    env.windDirection = windDirection;
+    env.windStrength = windStrength;
+    env.airDensity = airDensity;
+    env.g = g;
+    env.windField = &windField;
+
+    // Find controlled body
+    for (const ModelData &model : SceneManager::currentScene->structModels)
+    {
+        if (model.controlled && model.physicsIndex >= 0)
+            env.controlledBody = model.physicsIndex;
+    }
+
+    // Sample inputs
+    env.inputs.controller = InputManager::inputType == InputType::Controller;
+    env.inputs.buttonA = ControllerManager::state.buttons[GLFW_GAMEPAD_BUTTON_A].held();
+    env.inputs.buttonB = ControllerManager::state.buttons[GLFW_GAMEPAD_BUTTON_B].held();
+    env.inputs.stick = glm::vec2(ControllerManager::state.sticks[0].x, ControllerManager::state.sticks[0].y);
+    std::copy(std::begin(keyInputs), std::end(keyInputs), std::begin(env.inputs.keys));
+
+    return env;
 }
 
 void PhysicsUtil::setup()
 {
-    // Setup all animated models
-    for (ModelData &model : SceneManager::currentScene.get()->structModels)
+    Scene *scene = SceneManager::currentScene.get();
+    scene->physicsWorld.clear();
+
+    // Add all models with physics to the world
+    for (ModelData &model : scene->structModels)
     {
-        if (model.physicsTypes.size() > 0)
-        {
-            model.physics.emplace();
+        if (model.physicsTypes.size() == 0)
+            continue;
 
-            model.physics->buffers[0] = std::make_unique<Physics>(model);
-            model.physics->buffers[1] = std::make_unique<Physics>(model);
+        PhysicsBodyDesc desc;
+        desc.types = model.physicsTypes;
+        desc.transform = model.u_model;
 
-            model.physics->buffers[0]->reset(model.u_model);
-            model.physics->buffers[1]->reset(model.u_model);
+        if (model.model->modelType == ModelType::Yacht)
+        {
+            auto it = yachtPresets.find(model.model->name);
+            if (it != yachtPresets.end())
+                desc.preset = &it->second;
+            else
+                std::cerr << "Yacht physics properties not found for: " << model.model->name << std::endl;
         }
+
+        // Hulls are built once per model at load and shared between its instances
+        desc.hitboxHulls = model.model->hitboxHulls;
+
+        model.physicsIndex = scene->physicsWorld.addBody(desc);
     }
+
+    // Centre the wind field on the bodies
+    glm::vec2 center(0.0f);
+    int bodyCount = 0;
+    for (const ModelData &model : scene->structModels)
+    {
+        if (model.physicsIndex < 0)
+            continue;
+        center += glm::vec2(model.u_model[3]);
+        bodyCount++;
+    }
+    if (bodyCount > 0)
+        center /= static_cast<float>(bodyCount);
+
+    windField.generate(windFieldResolution, windFieldCellSize, center, windDirection, windStrength);
 }
 
 void PhysicsUtil::switchControlledYacht()
@@ -4,8 +4,13 @@
 
 #include <atomic>
 
+#include "physics/physics_defs.h"
+#include "physics/wind_field.hpp"
+
 struct Scene;
 struct ModelData;
+class PhysicsWorld;
+class WorkerPool;
 
 inline void atomicAdd(std::atomic<double> &atomicVal, double value)
 {
@@ -23,17 +28,21 @@ namespace PhysicsUtil
 
     inline std::atomic<double> accumulator = 0.0;
 
-    inline std::atomic<bool> isSwapping(false);
-
     // World variables
     inline glm::vec3 windDirection = glm::vec3(0.0f, 1.0f, 0.0f);
     inline float windStrength = 10.0f;
     inline float airDensity = 1.225f;
     inline float g = 9.80665f;
 
+    // Wind field over the course, rebuilt around the bodies on setup
+    inline WindField windField;
+    inline int windFieldResolution = 1024;
+    inline float windFieldCellSize = 2.0f;
+
     // Functions
     void setup();
-    void stepPhysics(ModelData &model);
+    void stepPhysics(PhysicsWorld &world, WorkerPool *pool = nullptr);
+    PhysicsEnvironment getEnvironment();
     void switchControlledYacht();
 
     // Boolmap for tracking inputs
@@ -0,0 +1,707 @@
+#include "physics/physics_world.hpp"
+
+// No pch here, the world only depends on glm so it can be built without a GL context
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#include "physics/wind_field.hpp"
+#include "thread_manager/worker_pool.hpp"
+
+namespace
+{
+    // Signed angle from a to b around the up axis, from the horizontal parts only
+    float angleAroundUp(const glm::vec3 &a, const glm::vec3 &b)
+    {
+        return std::atan2(a.x * b.y - a.y * b.x, a.x * b.x + a.y * b.y);
+    }
+
+    // Append one value to a field in all buffered states
+    template <typename Group, typename T>
+    void pushState(PhysicsState (&states)[3], Group PhysicsState::*group, std::vector<T> Group::*field, const T &value)
+    {
+        for (int i = 0; i < 3; i++)
+            (states[i].*group.*field).push_back(value);
+    }
+
+    // Power of two table with room for entries at half load, only ever grows
+    template <typename Entry>
+    void reserveTable(std::vector<Entry> &table, size_t entries)
+    {
+        size_t capacity = 16;
+        while (capacity < 2 * entries)
+            capacity *= 2;
+
+        if (table.size() < capacity)
+            table.assign(capacity, Entry());
+    }
+
+    // Linear probing from the key's hash, stops at the key or the first empty entry
+    template <typename Entry>
+    Entry &probeTable(std::vector<Entry> &table, uint64_t key, uint64_t emptyKey)
+    {
+        size_t mask = table.size() - 1;
+        size_t slot = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+        while (table[slot].key != key && table[slot].key != emptyKey)
+            slot = (slot + 1) & mask;
+        return table[slot];
+    }
+}
+
+int PhysicsWorld::addBody(const PhysicsBodyDesc &desc)
+{
+    int index = static_cast<int>(bodyCount());
+
+    // Base state
+    glm::vec3 pos = glm::vec3(desc.transform[3]);
+    glm::quat rot = glm::quat_cast(glm::mat3(desc.transform));
+
+    pushState(states, &PhysicsState::base, &BaseVariables::pos, pos);
+    pushState(states, &PhysicsState::base, &BaseVariables::prevPos, pos);
+    pushState(states, &PhysicsState::base, &BaseVariables::vel, glm::vec3(0.0f));
+    pushState(states, &PhysicsState::base, &BaseVariables::acc, glm::vec3(0.0f));
+    pushState(states, &PhysicsState::base, &BaseVariables::netForce, glm::vec3(0.0f));
+    pushState(states, &PhysicsState::base, &BaseVariables::rot, rot);
+    pushState(states, &PhysicsState::base, &BaseVariables::prevRot, rot);
+    pushState(states, &PhysicsState::base, &BaseVariables::onGround, uint8_t(0));
+
+    baseProperties.mass.push_back(desc.preset ? desc.preset->body.mass : 1.0f);
+    baseProperties.applyGravity.push_back(0);
+
+    sailSlot.push_back(-1);
+    drivingSlot.push_back(-1);
+    velHoriz.push_back(glm::vec3(0.0f));
+
+    for (auto type : desc.types)
+    {
+        switch (type)
+        {
+        case PhysicsType::Body:
+            bodyProperties.body.push_back(index);
+            bodyProperties.dragCoefficient.push_back(desc.preset ? desc.preset->body.dragCoefficient : 0.0f);
+            bodyProperties.area.push_back(desc.preset ? desc.preset->body.bodyArea : 0.0f);
+            break;
+        case PhysicsType::Sail:
+            sailSlot[index] = static_cast<int>(sailProperties.body.size());
+            sailProperties.body.push_back(index);
+            sailProperties.area.push_back(desc.preset ? desc.preset->sail.sailArea : 0.0f);
+            sailProperties.maxMastAngle.push_back(desc.preset ? glm::radians(desc.preset->sail.maxMastAngle) : 0.0f);
+            sailProperties.maxBoomAngle.push_back(desc.preset ? glm::radians(desc.preset->sail.maxBoomAngle) : 0.0f);
+            {
+                float maxLift = desc.preset ? desc.preset->sail.maxLiftCoefficient : 0.0f;
+                float minDrag = desc.preset ? desc.preset->sail.minDragCoefficient : 0.0f;
+                float optimal = desc.preset ? glm::radians(desc.preset->sail.optimalAngle) : 1.0f;
+
+                // Build the table the first time these coefficients show up
+                auto &tables = sailProperties.tables;
+                auto table = std::find_if(tables.begin(), tables.end(), [&](const SailCoefficientTable &t)
+                                          { return t.maxLiftCoefficient == maxLift && t.minDragCoefficient == minDrag && t.optimalAngle == optimal; });
+                if (table == tables.end())
+                {
+                    tables.emplace_back().build(maxLift, minDrag, optimal);
+                    table = tables.end() - 1;
+                }
+                sailProperties.table.push_back(static_cast<int>(table - tables.begin()));
+            }
+
+            sailWind.push_back(glm::vec3(0.0f));
+
+            pushState(states, &PhysicsState::sail, &SailVariables::controlFactor, 1.0f);
+            pushState(states, &PhysicsState::sail, &SailVariables::MastAngle, 0.0f);
+            pushState(states, &PhysicsState::sail, &SailVariables::prevMastAngle, 0.0f);
+            pushState(states, &PhysicsState::sail, &SailVariables::BoomAngle, 0.0f);
+            pushState(states, &PhysicsState::sail, &SailVariables::prevBoomAngle, 0.0f);
+            pushState(states, &PhysicsState::sail, &SailVariables::SailAngle, 0.0f);
+            pushState(states, &PhysicsState::sail, &SailVariables::prevSailAngle, 0.0f);
+            break;
+        case PhysicsType::Driving:
+            drivingSlot[index] = static_cast<int>(drivingProperties.body.size());
+            drivingProperties.body.push_back(index);
+            drivingProperties.steeringSmoothness.push_back(desc.preset ? desc.preset->driving.steeringSmoothness : 0.0f);
+            drivingProperties.maxSteeringAngle.push_back(desc.preset ? desc.preset->driving.maxSteeringAngle : 0.0f);
+            drivingProperties.steeringAttenuation.push_back(desc.preset ? desc.preset->driving.steeringAttenuation : 0.0f);
+            drivingProperties.rollCoefficient.push_back(desc.preset ? desc.preset->driving.rollCoefficient : 0.0f);
+            drivingProperties.rollScaling.push_back(desc.preset ? desc.preset->driving.rollScaling : 1.0f);
+
+            pushState(states, &PhysicsState::driving, &DrivingVariables::steeringChange, 0.0f);
+            pushState(states, &PhysicsState::driving, &DrivingVariables::steeringAngle, 0.0f);
+            pushState(states, &PhysicsState::driving, &DrivingVariables::prevSteeringAngle, 0.0f);
+            pushState(states, &PhysicsState::driving, &DrivingVariables::wheelAngle, 0.0f);
+            pushState(states, &PhysicsState::driving, &DrivingVariables::prevWheelAngle, 0.0f);
+            break;
+        case PhysicsType::Gravity:
+            baseProperties.applyGravity[index] = 1;
+            break;
+        case PhysicsType::Collision:
+            collisionProperties.body.push_back(index);
+            collisionProperties.hulls.push_back(desc.hitboxHulls);
+            collisionProperties.supportOffset.push_back(static_cast<int>(lastSupport.size()));
+            {
+                float radius = 0.0f;
+                if (desc.hitboxHulls)
+                    for (const auto &hull : *desc.hitboxHulls)
+                    {
+                        lastSupport.push_back(0);
+                        for (const auto &vertex : hull.vertices)
+                            radius = std::max(radius, glm::length(vertex));
+                    }
+                collisionProperties.radius.push_back(radius);
+
+                // Room for every hull touching a few others, so ticks do not grow the pair caches
+                reserveTable(pairCache, 4 * lastSupport.size());
+                reserveTable(lastPairCache, 4 * lastSupport.size());
+
+                // Cells at least as wide as the largest body keep each body in at most 2x2 cells
+                if (2.0f * radius > broadphase.getCellSize())
+                    broadphase.setCellSize(2.0f * radius);
+            }
+            collisionCenters.push_back(pos);
+            break;
+        }
+    }
+
+    return index;
+}
+
+void PhysicsWorld::clear()
+{
+    for (auto &state : states)
+        state = PhysicsState();
+
+    sailSlot.clear();
+    drivingSlot.clear();
+    baseProperties = BaseProperties();
+    bodyProperties = BodyProperties();
+    sailProperties = SailProperties();
+    drivingProperties = DrivingProperties();
+    collisionProperties = CollisionProperties();
+    debug = PhysicsDebug();
+    lastSupport.clear();
+    velHoriz.clear();
+    sailWind.clear();
+    time = 0.0;
+    broadphase = Broadphase();
+    collisionCenters.clear();
+    pairCache.clear();
+    lastPairCache.clear();
+    contacts.clear();
+
+    sharedSlot.store(2, std::memory_order_relaxed);
+    writeSlot = 0;
+    publishedSlot = 2;
+    readSlot = 1;
+}
+
+void PhysicsWorld::beginTicks()
+{
+    PhysicsState &write = getWriteState();
+
+    // Same sizes in all states, so this copies without allocating
+    write = states[publishedSlot];
+
+    write.base.prevPos = write.base.pos;
+    write.base.prevRot = write.base.rot;
+
+    write.sail.prevMastAngle = write.sail.MastAngle;
+    write.sail.prevBoomAngle = write.sail.BoomAngle;
+    write.sail.prevSailAngle = write.sail.SailAngle;
+
+    write.driving.prevSteeringAngle = write.driving.steeringAngle;
+    write.driving.prevWheelAngle = write.driving.wheelAngle;
+}
+
+void PhysicsWorld::publish()
+{
+    publishedSlot = writeSlot;
+
+    // Release makes the written state visible, the old shared slot becomes the next write slot
+    int previous = sharedSlot.exchange(writeSlot | freshFlag, std::memory_order_acq_rel);
+    writeSlot = previous & ~freshFlag;
+}
+
+const PhysicsState &PhysicsWorld::acquireReadState()
+{
+    if (sharedSlot.load(std::memory_order_relaxed) & freshFlag)
+    {
+        int previous = sharedSlot.exchange(readSlot, std::memory_order_acq_rel);
+        readSlot = previous & ~freshFlag;
+    }
+    return states[readSlot];
+}
+
+PhysicsRange PhysicsWorld::getRange(size_t begin, size_t end) const
+{
+    // Component arrays are filled in body order, so each range is contiguous
+    auto slots = [&](const std::vector<int> &bodies, size_t &first, size_t &last)
+    {
+        first = std::lower_bound(bodies.begin(), bodies.end(), static_cast<int>(begin)) - bodies.begin();
+        last = std::lower_bound(bodies.begin(), bodies.end(), static_cast<int>(end)) - bodies.begin();
+    };
+
+    PhysicsRange range;
+    range.begin = begin;
+    range.end = end;
+    slots(bodyProperties.body, range.bodyBegin, range.bodyEnd);
+    slots(sailProperties.body, range.sailBegin, range.sailEnd);
+    slots(drivingProperties.body, range.drivingBegin, range.drivingEnd);
+    slots(collisionProperties.body, range.collisionBegin, range.collisionEnd);
+    return range;
+}
+
+void PhysicsWorld::step(const PhysicsEnvironment &env)
+{
+    step(env, getRange(0, bodyCount()));
+    findCollisionPairs(getWriteState());
+    resolveContacts(getWriteState());
+    time += env.tickTime;
+}
+
+void PhysicsWorld::step(const PhysicsEnvironment &env, WorkerPool &pool)
+{
+    const size_t count = bodyCount();
+    const size_t minChunkSize = 64;
+
+    // A few chunks per thread so uneven chunks even out
+    size_t chunkCount = std::min<size_t>(pool.size() * 4, (count + minChunkSize - 1) / minChunkSize);
+    chunkCount = std::max<size_t>(chunkCount, 1);
+    const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+
+    auto task = [&](int chunk)
+    {
+        size_t begin = chunk * chunkSize;
+        size_t end = std::min(count, begin + chunkSize);
+        if (begin < end)
+            step(env, getRange(begin, end));
+    };
+
+    // Returns once every chunk is done, so ticks never overlap
+    pool.run(static_cast<int>(chunkCount), task);
+
+    findCollisionPairs(getWriteState());
+    resolveContacts(getWriteState());
+    time += env.tickTime;
+}
+
+void PhysicsWorld::step(const PhysicsEnvironment &env, const PhysicsRange &range)
+{
+    PhysicsState &state = getWriteState();
+
+    // Reset temp variables
+    std::fill(state.base.acc.begin() + range.begin, state.base.acc.begin() + range.end, glm::vec3(0.0f));
+    std::fill(state.base.netForce.begin() + range.begin, state.base.netForce.begin() + range.end, glm::vec3(0.0f));
+    std::fill(state.driving.steeringChange.begin() + range.drivingBegin, state.driving.steeringChange.begin() + range.drivingEnd, 0.0f);
+
+    const bool hasControlled = env.controlledBody >= static_cast<int>(range.begin) && env.controlledBody < static_cast<int>(range.end);
+
+    if (hasControlled)
+        updateInputs(state, env, range);
+
+    updateSteering(state, env, range);
+    updateWind(state, env, range);
+    updateSails(state, env, range);
+    updateDriving(state, env, range);
+    updateBodies(state, env, range);
+    updateGravity(state, env, range);
+    integrate(state, env, range);
+    checkCollisions(state, env, range);
+
+    if (hasControlled)
+    {
+        debug.hasSail = sailSlot[env.controlledBody] >= 0;
+        debug.hasDriving = drivingSlot[env.controlledBody] >= 0;
+        debug.velocity = glm::length(state.base.vel[env.controlledBody]);
+        debug.acceleration = glm::length(state.base.acc[env.controlledBody]);
+    }
+}
+
+void PhysicsWorld::updateInputs(PhysicsState &state, const PhysicsEnvironment &env, const PhysicsRange &range)
+{
+    const int i = env.controlledBody;
+    const int s = sailSlot[i];
+    const int d = drivingSlot[i];
+    const PhysicsInputs &inputs = env.inputs;
+
+    // Inputs only steer yachts
+    if (s < 0 || d < 0)
+        return;
+
+    float &controlFactor = state.sail.controlFactor[s];
+    float &steeringChange = state.driving.steeringChange[d];
+    const float steeringStep = drivingProperties.steeringSmoothness[d] * drivingProperties.maxSteeringAngle[d];
+
+    if (inputs.controller)
+    {
+        if (inputs.buttonA)
+            state.base.acc[i] += state.base.rot[i] * glm::vec3(0, 1, 0);
+
+        if (inputs.buttonB)
+            controlFactor = 1.0f;
+
+        steeringChange = -inputs.stick.x;
+
+        controlFactor += -inputs.stick.y * env.tickTime;
+    }
+    else
+    {
+        if (inputs.keys[0])
+            controlFactor += 1.f * env.tickTime;
+        if (inputs.keys[1])
+            controlFactor -= 0.4f * env.tickTime;
+        if (inputs.keys[2])
+            steeringChange += steeringStep;
+        if (inputs.keys[3])
+            steeringChange -= steeringStep;
+        if (inputs.keys[4])
+            state.base.acc[i] += state.base.rot[i] * glm::vec3(0, 1, 0);
+        if (inputs.keys[5])
+            controlFactor = 1.0f;
+    }
+
+    controlFactor = std::clamp(controlFactor, 0.2f, 1.0f);
+}
+
+void PhysicsWorld::updateSteering(PhysicsState &state, const PhysicsEnvironment &env, const PhysicsRange &range)
+{
+    float *steeringAngle = state.driving.steeringAngle.data();
+    const float *steeringChange = state.driving.steeringChange.data();
+    const float *maxSteeringAngle = drivingProperties.maxSteeringAngle.data();
+    const float *steeringSmoothness = drivingProperties.steeringSmoothness.data();
+
+    if (env.inputs.controller)
+    {
+        for (size_t d = range.drivingBegin; d < range.drivingEnd; d++)
+            steeringAngle[d] = 0.5f * steeringAngle[d] + 0.5f * steeringChange[d] * maxSteeringAngle[d];
+    }
+    else
+    {
+        for (size_t d = range.drivingBegin; d < range.drivingEnd; d++)
+            steeringAngle[d] += (steeringChange[d] - steeringAngle[d] * steeringSmoothness[d]) * env.tickTime;
+    }
+}
+
+void PhysicsWorld::updateWind(const PhysicsState &state, const PhysicsEnvironment &env, const PhysicsRange &range)
+{
+    const size_t count = range.sailEnd - range.sailBegin;
+
+    // One batched pass over all sails in the range
+    if (env.windField && !env.windField->empty())
+        env.windField->sample(state.base.pos.data(), sailProperties.body.data() + range.sailBegin, count,
+                              static_cast<float>(time), sailWind.data() + range.sailBegin);
+    else
+        std::fill(sailWind.begin() + range.sailBegin, sailWind.begin() + range.sailEnd, env.windDirection * env.windStrength);
+}
+
+void PhysicsWorld::updateSails(PhysicsState &state, const PhysicsEnvironment &env, const PhysicsRange &range)
+{
+    const float smoothingFactor = 0.05f;
+
+    for (size_t s = range.sailBegin; s < range.sailEnd; s++)
+    {
+        const int i = sailProperties.body[s];
+        const float controlFactor = state.sail.controlFactor[s];
+
+        const glm::vec3 trueWind = sailWind[s];
+        const float trueWindSpeed = glm::length(trueWind);
+        const glm::vec3 windDirection = trueWindSpeed > 1e-6f ? trueWind / trueWindSpeed : env.windDirection;
+
+        glm::vec3 heading = state.base.rot[i] * glm::vec3(0, 1, 0);
+        float angleToWind = angleAroundUp(heading, -windDirection);
+
+        float targetMastAngle = (0.5f + controlFactor) / 1.5f * std::clamp(angleToWind, -sailProperties.maxMastAngle[s], sailProperties.maxMastAngle[s]);
+        float targetBoomAngle = controlFactor * std::clamp(angleToWind, -sailProperties.maxBoomAngle[s], sailProperties.maxBoomAngle[s]);
+
+        state.sail.MastAngle[s] += smoothingFactor * (targetMastAngle - state.sail.MastAngle[s]);
+        state.sail.BoomAngle[s] += smoothingFactor * (targetBoomAngle - state.sail.BoomAngle[s]);
+        state.sail.SailAngle[s] = state.sail.BoomAngle[s] * (1.0f + 0.1f * std::fabs(std::sin(angleToWind / 2.0f)));
+
+        glm::vec3 apparentWind = trueWind - state.base.vel[i];
+        glm::vec3 apparentWindDirection = glm::normalize(apparentWind);
+        float apparentWindSpeed = glm::length(apparentWind);
+
+        // Rotate heading around up by the sail angle
+        float sinSail = std::sin(state.sail.SailAngle[s]);
+        float cosSail = std::cos(state.sail.SailAngle[s]);
+        glm::vec3 sailDir = glm::vec3(cosSail * heading.x - sinSail * heading.y, sinSail * heading.x + cosSail * heading.y, heading.z);
+
+        float angleAttack = angleAroundUp(-apparentWindDirection, sailDir);
+
+        // Lift and Drag coefficients
+        float CL, CD;
+        sailProperties.tables[sailProperties.table[s]].lookup(angleAttack, CL, CD);
+
+        // Lift and Drag forces
+        float dynamicPressure = 0.5f * env.airDensity * apparentWindSpeed * apparentWindSpeed;
+        float liftMagnitude = dynamicPressure * sailProperties.area[s] * CL;
+        float dragMagnitude = dynamicPressure * sailProperties.area[s] * CD;
+
+        glm::vec3 dragHorizontal = glm::normalize(glm::vec3(apparentWindDirection.x, apparentWindDirection.y, 0.0f));
+        glm::vec3 liftDir = glm::vec3(dragHorizontal.y, -dragHorizontal.x, 0.0f);
+
+        state.base.netForce[i] += liftMagnitude * liftDir + dragMagnitude * apparentWindDirection;
+
+        if (i == env.controlledBody)
+        {
+            debug.apparentWind = apparentWindSpeed;
+            debug.angleToWind = glm::degrees(angleToWind);
+            debug.angleAttack = glm::degrees(angleAttack);
+            debug.CL = CL;
+            debug.CD = CD;
+        }
+    }
+}
+
+void PhysicsWorld::updateDriving(PhysicsState &state, const PhysicsEnvironment &env, const PhysicsRange &range)
+{
+    const float wheelScale = 100.0f * env.tickTime;
+
+    for (size_t d = range.drivingBegin; d < range.drivingEnd; d++)
+    {
+        const int i = drivingProperties.body[d];
+        const glm::vec3 vel = state.base.vel[i];
+        const float speed = glm::length(vel);
+
+        // Rolling Resistance
+        if (speed > 1e-4f)
+        {
+            const float rollScaling = drivingProperties.rollScaling[d];
+            float effectiveCr = drivingProperties.rollCoefficient[d] * (1 + glm::dot(vel, vel) / (rollScaling * rollScaling));
+            float rollResistance = effectiveCr * baseProperties.mass[i] * env.g;
+            state.base.netForce[i] -= rollResistance * (vel / speed);
+        }
+
+        state.driving.wheelAngle[d] += speed * wheelScale;
+
+        float effectiveSteeringAngle = state.driving.steeringAngle[d] / (1 + drivingProperties.steeringAttenuation[d] * speed);
+
+        glm::quat deltaRot = glm::angleAxis(glm::radians(effectiveSteeringAngle * speed * env.tickTime), glm::vec3(0, 0, 1));
+        state.base.rot[i] = glm::normalize(deltaRot * state.base.rot[i]);
+
+        if (i == env.controlledBody)
+        {
+            debug.steeringAngle = state.driving.steeringAngle[d];
+            debug.effectiveSteeringAngle = effectiveSteeringAngle;
+        }
+    }
+}
+
+void PhysicsWorld::updateBodies(PhysicsState &state, const PhysicsEnvironment &env, const PhysicsRange &range)
+{
+    for (size_t b = range.bodyBegin; b < range.bodyEnd; b++)
+    {
+        const int i = bodyProperties.body[b];
+        const glm::vec3 vel = state.base.vel[i];
+        const float speed = glm::length(vel);
+
+        if (speed > 1e-4f)
+        {
+            float bodyDragForce = 0.5f * env.airDensity * bodyProperties.dragCoefficient[b] * bodyProperties.area[b] * speed * speed;
+            state.base.netForce[i] -= bodyDragForce * (vel / speed);
+        }
+    }
+}
+
+void PhysicsWorld::updateGravity(PhysicsState &state, const PhysicsEnvironment &env, const PhysicsRange &range)
+{
+    const uint8_t *applyGravity = baseProperties.applyGravity.data();
+    const uint8_t *onGround = state.base.onGround.data();
+    glm::vec3 *acc = state.base.acc.data();
+
+    for (size_t i = range.begin; i < range.end; i++)
+        acc[i].z -= (applyGravity[i] && !onGround[i]) ? env.g : 0.0f;
+}
+
+void PhysicsWorld::integrate(PhysicsState &state, const PhysicsEnvironment &env, const PhysicsRange &range)
+{
+    // Stationary force/acceleration
+    const float standstillVelocity = 0.02f;
+    const float staticFrictionCoeff = 0.3f;
+
+    glm::vec3 *pos = state.base.pos.data();
+    glm::vec3 *vel = state.base.vel.data();
+    glm::vec3 *acc = state.base.acc.data();
+    glm::vec3 *netForce = state.base.netForce.data();
+    const float *mass = baseProperties.mass.data();
+
+    for (size_t i = range.begin; i < range.end; i++)
+    {
+        velHoriz[i] = glm::vec3(vel[i].x, vel[i].y, 0.0f);
+
+        float maxStaticFriction = staticFrictionCoeff * mass[i] * env.g;
+        float netForceHoriz = glm::length(glm::vec2(netForce[i].x, netForce[i].y));
+
+        // If stationary
+        if ((glm::length(velHoriz[i]) < standstillVelocity) && (netForceHoriz < maxStaticFriction))
+        {
+            netForce[i] = glm::vec3(0.0f);
+            vel[i].x *= 0.2f;
+            vel[i].y *= 0.2f;
+        }
+
+        acc[i] += netForce[i] / mass[i];
+        vel[i] += acc[i] * env.tickTime;
+    }
+
+    // Wheels only roll forward, remove most of the sideways velocity
+    for (size_t d = range.drivingBegin; d < range.drivingEnd; d++)
+    {
+        const int i = drivingProperties.body[d];
+        glm::vec3 forward = state.base.rot[i] * glm::vec3(0, 1, 0);
+        glm::vec3 forwardHoriz = glm::normalize(glm::vec3(forward.x, forward.y, 0.0f));
+        glm::vec3 lateral = velHoriz[i] - glm::dot(velHoriz[i], forwardHoriz) * forwardHoriz;
+        vel[i] -= lateral * 0.9f;
+    }
+
+    for (size_t i = range.begin; i < range.end; i++)
+        pos[i] += vel[i] * env.tickTime;
+}
+
+void PhysicsWorld::checkCollisions(PhysicsState &state, const PhysicsEnvironment &env, const PhysicsRange &range)
+{
+    const float groundPos = 0.0f;
+
+    for (size_t c = range.collisionBegin; c < range.collisionEnd; c++)
+    {
+        const int i = collisionProperties.body[c];
+        const glm::quat rot = state.base.rot[i];
+
+        // Lowest hitbox point, found in model space
+        glm::vec3 modelDirection = glm::conjugate(rot) * glm::vec3(0, 0, -1);
+
+        const auto &hulls = collisionProperties.hulls[c];
+        if (!hulls || hulls->empty())
+            continue;
+
+        // Rotation changes little per tick, so climbing from the last support takes a few steps
+        int *support = lastSupport.data() + collisionProperties.supportOffset[c];
+        float maxDot = -1e20f;
+        glm::vec3 furthest(0.0f);
+        for (size_t h = 0; h < hulls->size(); h++)
+        {
+            const ConvexHull &hull = (*hulls)[h];
+            if (hull.vertices.empty())
+                continue;
+
+            support[h] = hull.support(modelDirection, support[h]);
+            float dot = glm::dot(hull.vertices[support[h]], modelDirection);
+            if (dot > maxDot)
+            {
+                maxDot = dot;
+                furthest = hull.vertices[support[h]];
+            }
+        }
+        if (maxDot == -1e20f)
+            continue;
+
+        float penetration = groundPos - ((rot * furthest).z + state.base.pos[i].z);
+
+        if (penetration > 0.0f)
+        {
+            state.base.pos[i].z += penetration;
+            state.base.vel[i].z = 0.0f;
+            state.base.acc[i].z = 0.0f;
+            state.base.onGround[i] = 1;
+        }
+    }
+}
+
+void PhysicsWorld::findCollisionPairs(const PhysicsState &state)
+{
+    const size_t count = collisionProperties.body.size();
+    if (count < 2)
+        return;
+
+    for (size_t c = 0; c < count; c++)
+        collisionCenters[c] = state.base.pos[collisionProperties.body[c]];
+
+    broadphase.update(collisionCenters.data(), collisionProperties.radius.data(), count);
+}
+
+void PhysicsWorld::resolveContacts(PhysicsState &state)
+{
+    contacts.clear();
+
+    const std::vector<CollisionPair> &pairs = broadphase.getPairs();
+
+    // Last tick's entries are only read, this tick's table starts empty
+    std::swap(pairCache, lastPairCache);
+
+    size_t hullPairs = 0;
+    for (const CollisionPair &pair : pairs)
+        if (collisionProperties.hulls[pair.a] && collisionProperties.hulls[pair.b])
+            hullPairs += collisionProperties.hulls[pair.a]->size() * collisionProperties.hulls[pair.b]->size();
+
+    reserveTable(pairCache, hullPairs);
+    std::fill(pairCache.begin(), pairCache.end(), PairCache());
+
+    for (const CollisionPair &pair : pairs)
+    {
+        const auto &hullsA = collisionProperties.hulls[pair.a];
+        const auto &hullsB = collisionProperties.hulls[pair.b];
+        if (!hullsA || !hullsB)
+            continue;
+
+        const int i = collisionProperties.body[pair.a];
+        const int j = collisionProperties.body[pair.b];
+        const int supportA = collisionProperties.supportOffset[pair.a];
+        const int supportB = collisionProperties.supportOffset[pair.b];
+
+        // Deepest contact over all hull pairs
+        Contact deepest;
+        bool hit = false;
+        for (size_t ha = 0; ha < hullsA->size(); ha++)
+            for (size_t hb = 0; hb < hullsB->size(); hb++)
+            {
+                const uint64_t key = (static_cast<uint64_t>(supportA + ha) << 32) | static_cast<uint32_t>(supportB + hb);
+
+                // Warm start from last tick's entry, a new pair starts from each hull's last support
+                PairCache &cache = probeTable(pairCache, key, emptyPairKey);
+                const PairCache &last = lastPairCache.empty() ? cache : probeTable(lastPairCache, key, emptyPairKey);
+                if (last.key == key)
+                    cache = last;
+                else
+                {
+                    cache.key = key;
+                    cache.supportA = lastSupport[supportA + ha];
+                    cache.supportB = lastSupport[supportB + hb];
+                }
+
+                CollisionShape a{&(*hullsA)[ha], state.base.pos[i], state.base.rot[i], cache.supportA};
+                CollisionShape b{&(*hullsB)[hb], state.base.pos[j], state.base.rot[j], cache.supportB};
+
+                Contact contact;
+                if (Narrowphase::collide(a, b, cache.axis, contact) && (!hit || contact.depth > deepest.depth))
+                {
+                    deepest = contact;
+                    hit = true;
+                }
+
+                cache.supportA = a.lastSupport;
+                cache.supportB = b.lastSupport;
+            }
+
+        if (!hit)
+            continue;
+
+        contacts.push_back(deepest);
+
+        // Push bodies apart along the normal, the lighter body moves more
+        const float invMassA = 1.0f / baseProperties.mass[i];
+        const float invMassB = 1.0f / baseProperties.mass[j];
+        const float invMassSum = invMassA + invMassB;
+        const glm::vec3 &normal = deepest.normal;
+
+        glm::vec3 correction = normal * (deepest.depth / invMassSum);
+        state.base.pos[i] -= correction * invMassA;
+        state.base.pos[j] += correction * invMassB;
+
+        // Inelastic, remove the approaching part of the relative velocity
+        float approach = glm::dot(state.base.vel[j] - state.base.vel[i], normal);
+        if (approach < 0.0f)
+        {
+            float impulse = -approach / invMassSum;
+            state.base.vel[i] -= normal * (impulse * invMassA);
+            state.base.vel[j] += normal * (impulse * invMassB);
+        }
+    }
+}
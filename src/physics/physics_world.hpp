@@ -0,0 +1,114 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "physics/physics_defs.h"
+#include "physics/broadphase.hpp"
+#include "physics/narrowphase.hpp"
+
+class WorkerPool;
+
+// Bodies [begin, end) and the component slots that belong to them
+struct PhysicsRange
+{
+    size_t begin = 0, end = 0;
+    size_t bodyBegin = 0, bodyEnd = 0;
+    size_t sailBegin = 0, sailEnd = 0;
+    size_t drivingBegin = 0, drivingEnd = 0;
+    size_t collisionBegin = 0, collisionEnd = 0;
+};
+
+// All physics bodies of a scene, stored as structure of arrays and stepped in batches
+class PhysicsWorld
+{
+public:
+    int addBody(const PhysicsBodyDesc &desc);
+    void clear();
+    size_t bodyCount() const { return baseProperties.mass.size(); }
+
+    PhysicsWorld() = default;
+    PhysicsWorld(const PhysicsWorld &) = delete;
+    PhysicsWorld &operator=(const PhysicsWorld &) = delete;
+
+    // Copy last published state into the write state and keep previous values for interpolation
+    void beginTicks();
+    void step(const PhysicsEnvironment &env);
+    void step(const PhysicsEnvironment &env, WorkerPool &pool);
+    void step(const PhysicsEnvironment &env, const PhysicsRange &range);
+    PhysicsRange getRange(size_t begin, size_t end) const;
+    // Physics thread, hand the write state to readers with one atomic exchange
+    void publish();
+
+    // Reader, take the newest published state if there is one, never waits on physics
+    const PhysicsState &acquireReadState();
+    const PhysicsState &getReadState() const { return states[readSlot]; }
+
+    PhysicsState &getWriteState() { return states[writeSlot]; }
+
+    // Component slot per body, -1 if the body has no such component
+    std::vector<int> sailSlot;
+    std::vector<int> drivingSlot;
+
+    BaseProperties baseProperties;
+    BodyProperties bodyProperties;
+    SailProperties sailProperties;
+    DrivingProperties drivingProperties;
+    CollisionProperties collisionProperties;
+
+    PhysicsDebug debug;
+
+    // Candidate pairs from the last tick, as collision slots
+    const std::vector<CollisionPair> &getCollisionPairs() const { return broadphase.getPairs(); }
+    // Resolved contacts from the last tick
+    const std::vector<Contact> &getContacts() const { return contacts; }
+
+private:
+    // Triple buffer, the shared slot carries a flag telling the reader it holds a new state
+    static constexpr int freshFlag = 4;
+    PhysicsState states[3];
+    std::atomic<int> sharedSlot{2};
+    int writeSlot = 0;
+    int publishedSlot = 2;
+    int readSlot = 1;
+
+    // Last support vertex per hull, support queries climb from here
+    std::vector<int> lastSupport;
+
+    // Horizontal velocity before integration, used for lateral grip
+    std::vector<glm::vec3> velHoriz;
+
+    // True wind per sail slot, sampled at the start of each tick
+    std::vector<glm::vec3> sailWind;
+    double time = 0.0;
+
+    Broadphase broadphase;
+    std::vector<glm::vec3> collisionCenters;
+
+    // Separating axis and support vertices per hull pair, keyed by the support slots of both hulls
+    // Flat open addressed tables, last tick's is read while this tick's is filled so pairs that stop being candidates drop out
+    static constexpr uint64_t emptyPairKey = ~0ull;
+    struct PairCache
+    {
+        uint64_t key = emptyPairKey;
+        glm::vec3 axis = glm::vec3(0.0f);
+        int supportA = 0, supportB = 0;
+    };
+    std::vector<PairCache> pairCache, lastPairCache;
+    std::vector<Contact> contacts;
+
+    void updateInputs(PhysicsState &state, const PhysicsEnvironment &env, const PhysicsRange &range);
+    void updateWind(const PhysicsState &state, const PhysicsEnvironment &env, const PhysicsRange &range);
+    void updateSteering(PhysicsState &state, const PhysicsEnvironment &env, const PhysicsRange &range);
+    void updateSails(PhysicsState &state, const PhysicsEnvironment &env, const PhysicsRange &range);
+    void updateDriving(PhysicsState &state, const PhysicsEnvironment &env, const PhysicsRange &range);
+    void updateBodies(PhysicsState &state, const PhysicsEnvironment &env, const PhysicsRange &range);
+    void updateGravity(PhysicsState &state, const PhysicsEnvironment &env, const PhysicsRange &range);
+    void integrate(PhysicsState &state, const PhysicsEnvironment &env, const PhysicsRange &range);
+    void checkCollisions(PhysicsState &state, const PhysicsEnvironment &env, const PhysicsRange &range);
+    void findCollisionPairs(const PhysicsState &state);
+    void resolveContacts(PhysicsState &state);
+};
@@ -1,27 +0,0 @@
-#pragma once
-
-#include <memory>
-#include <thread>
-#include <variant>
-
-#include "physics/physics.hpp"
-#include "physics/physics_util.hpp"
-
-struct PhysicsBuffer
-{
-    std::unique_ptr<Physics> buffers[2];
-    int readIndex = 0;
-
-    Physics *getReadBuffer()
-    {
-        while (PhysicsUtil::isSwapping.load(std::memory_order_acquire))
-        {
-            std::this_thread::yield();
-        }
-        return buffers[readIndex % 2].get();
-    }
-
-    Physics *getWriteBuffer() { return buffers[(readIndex + 1) % 2].get(); }
-
-    void swapBuffers() { readIndex = (readIndex + 1) % 2; }
-};
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "physics/telemetry.hpp"
+
+#include <mutex>
+#include <stdexcept>
+
+namespace
+{
+    // Fixed array so readers never see a reallocation, only the interning side locks
+    struct KeyTable
+    {
+        std::array<std::string, Telemetry::maxKeys> names;
+        std::atomic<int> count = 0;
+        std::mutex mutex;
+        const std::string unknown = "?";
+    };
+
+    // Built on first use, keys are interned from static initializers in other files
+    KeyTable &keyTable()
+    {
+        static KeyTable table;
+        return table;
+    }
+}
+
+Telemetry::Key Telemetry::intern(const std::string &name)
+{
+    KeyTable &table = keyTable();
+    std::lock_guard lock(table.mutex);
+
+    int count = table.count.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; i++)
+        if (table.names[i] == name)
+            return static_cast<Key>(i);
+
+    if (count == maxKeys)
+        throw std::runtime_error("Too many telemetry keys, can not intern: " + name);
+
+    table.names[count] = name;
+    table.count.store(count + 1, std::memory_order_release);
+    return static_cast<Key>(count);
+}
+
+const std::string &Telemetry::name(Key key)
+{
+    KeyTable &table = keyTable();
+    if (key >= table.count.load(std::memory_order_acquire))
+        return table.unknown;
+    return table.names[key];
+}
+
+Telemetry::Frame *Telemetry::Channel::beginFrame()
+{
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == capacity)
+        return nullptr;
+
+    Frame &frame = frames[h % capacity];
+    frame.count = 0;
+    return &frame;
+}
+
+void Telemetry::Channel::commitFrame()
+{
+    head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+bool Telemetry::Channel::readLatest(Frame &latest)
+{
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t h = head.load(std::memory_order_acquire);
+    if (t == h)
+        return false;
+
+    // Older frames are skipped, the overlay only shows the newest
+    latest = frames[(h - 1) % capacity];
+    tail.store(h, std::memory_order_release);
+    return true;
+}
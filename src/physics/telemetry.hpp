@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Debug values passed from the physics thread to the overlay without locks or allocations
+namespace Telemetry
+{
+    // Names are interned once up front, records only carry the index
+    using Key = uint16_t;
+    constexpr int maxKeys = 64;
+
+    Key intern(const std::string &name);
+    const std::string &name(Key key);
+
+    struct Record
+    {
+        Key key;
+        float value;
+    };
+
+    // All records of one physics tick
+    struct Frame
+    {
+        static constexpr int maxRecords = 16;
+
+        int count = 0;
+        Record records[maxRecords];
+
+        void push(Key key, float value)
+        {
+            if (count < maxRecords)
+                records[count++] = {key, value};
+        }
+    };
+
+    // Single producer, single consumer ring of frames
+    class Channel
+    {
+    public:
+        // Set by the reader, the writer skips all work while this is off
+        std::atomic<bool> enabled = false;
+
+        // Slot for the next frame, nullptr if the reader fell behind and the ring is full
+        Frame *beginFrame();
+        void commitFrame();
+
+        // Drains everything written so far into latest, false if nothing new arrived
+        bool readLatest(Frame &latest);
+
+    private:
+        static constexpr uint32_t capacity = 16;
+        std::array<Frame, capacity> frames;
+
+        alignas(64) std::atomic<uint32_t> head = 0;
+        alignas(64) std::atomic<uint32_t> tail = 0;
+    };
+
+    inline Channel physics;
+};
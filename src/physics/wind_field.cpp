@@ -0,0 +1,214 @@
+#include "physics/wind_field.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define WIND_FIELD_SSE2 1
+#endif
+
+namespace
+{
+    // Random values every spacing cells, smoothly interpolated in between, in [-1, 1]
+    std::vector<float> valueNoise(std::mt19937 &rng, int resolution, int spacing)
+    {
+        std::uniform_real_distribution<float> random(-1.0f, 1.0f);
+
+        int coarse = resolution / spacing + 2;
+        std::vector<float> nodes(coarse * coarse);
+        for (auto &node : nodes)
+            node = random(rng);
+
+        std::vector<float> noise(resolution * resolution);
+        for (int y = 0; y < resolution; y++)
+            for (int x = 0; x < resolution; x++)
+            {
+                float u = static_cast<float>(x) / spacing, v = static_cast<float>(y) / spacing;
+                int iu = static_cast<int>(u), iv = static_cast<int>(v);
+                float fu = u - iu, fv = v - iv;
+
+                // Smoothstep hides the grid lines
+                fu = fu * fu * (3.0f - 2.0f * fu);
+                fv = fv * fv * (3.0f - 2.0f * fv);
+
+                float n0 = nodes[iv * coarse + iu] + fu * (nodes[iv * coarse + iu + 1] - nodes[iv * coarse + iu]);
+                float n1 = nodes[(iv + 1) * coarse + iu] + fu * (nodes[(iv + 1) * coarse + iu + 1] - nodes[(iv + 1) * coarse + iu]);
+                noise[y * resolution + x] = n0 + fv * (n1 - n0);
+            }
+
+        return noise;
+    }
+}
+
+void WindField::generate(int resolution, float cellSize, const glm::vec2 &center, const glm::vec3 &direction, float strength, uint32_t seed)
+{
+    clear();
+    if (resolution < 2)
+        return;
+
+    this->resolution = resolution;
+    this->cellSize = cellSize;
+    invCellSize = 1.0f / cellSize;
+    origin = center - glm::vec2(0.5f * (resolution - 1) * cellSize);
+
+    glm::vec2 flatDirection = glm::vec2(direction);
+    if (glm::length(flatDirection) > 0.0f)
+        flatDirection = glm::normalize(flatDirection);
+    meanWind = flatDirection * strength;
+
+    std::mt19937 rng(seed);
+
+    // Slow shifts in direction and strength across the course
+    std::vector<float> angleNoise = valueNoise(rng, resolution, std::max(2, resolution / 8));
+    std::vector<float> strengthNoise = valueNoise(rng, resolution, std::max(2, resolution / 16));
+
+    cells.resize(resolution * resolution);
+    for (int i = 0; i < resolution * resolution; i++)
+    {
+        float angle = 0.25f * angleNoise[i];
+        float speed = strength * (1.0f + 0.2f * strengthNoise[i]);
+        float sinAngle = std::sin(angle), cosAngle = std::cos(angle);
+        cells[i] = speed * glm::vec2(cosAngle * flatDirection.x - sinAngle * flatDirection.y, sinAngle * flatDirection.x + cosAngle * flatDirection.y);
+    }
+
+    // Gust factors around 1, the grid wraps so it can drift forever
+    std::vector<float> gustNoise = valueNoise(rng, gustResolution, 4);
+    gusts.resize(gustResolution * gustResolution);
+    for (int i = 0; i < gustResolution * gustResolution; i++)
+        gusts[i] = gustNoise[i];
+
+    // Make the right and top edges match the left and bottom so the tile repeats without seams
+    for (int y = 0; y < gustResolution; y++)
+        for (int x = 0; x < gustResolution; x++)
+        {
+            float wx = static_cast<float>(x) / gustResolution, wy = static_cast<float>(y) / gustResolution;
+            int mx = gustResolution - 1 - x, my = gustResolution - 1 - y;
+            gusts[y * gustResolution + x] = (1.0f - wx) * (1.0f - wy) * gustNoise[y * gustResolution + x] + wx * (1.0f - wy) * gustNoise[y * gustResolution + mx] +
+                                            (1.0f - wx) * wy * gustNoise[my * gustResolution + x] + wx * wy * gustNoise[my * gustResolution + mx];
+        }
+}
+
+void WindField::clear()
+{
+    resolution = 0;
+    cells.clear();
+    gusts.clear();
+}
+
+glm::vec3 WindField::sample(const glm::vec3 &position, float time) const
+{
+    // Base field, clamped at the edges
+    float u = std::clamp((position.x - origin.x) * invCellSize, 0.0f, resolution - 1.001f);
+    float v = std::clamp((position.y - origin.y) * invCellSize, 0.0f, resolution - 1.001f);
+    int iu = static_cast<int>(u), iv = static_cast<int>(v);
+    float fu = u - iu, fv = v - iv;
+
+    const glm::vec2 *cell = cells.data() + iv * resolution + iu;
+    glm::vec2 wind0 = cell[0] + fu * (cell[1] - cell[0]);
+    glm::vec2 wind1 = cell[resolution] + fu * (cell[resolution + 1] - cell[resolution]);
+    glm::vec2 wind = wind0 + fv * (wind1 - wind0);
+
+    // Gusts, wrapped
+    const int mask = gustResolution - 1;
+    float gu = (position.x - meanWind.x * time) * (1.0f / gustCellSize);
+    float gv = (position.y - meanWind.y * time) * (1.0f / gustCellSize);
+    float flu = std::floor(gu), flv = std::floor(gv);
+    float gfu = gu - flu, gfv = gv - flv;
+    int x0 = static_cast<int>(flu) & mask, y0 = static_cast<int>(flv) & mask;
+    int x1 = (x0 + 1) & mask, y1 = (y0 + 1) & mask;
+
+    float gust0 = gusts[y0 * gustResolution + x0] + gfu * (gusts[y0 * gustResolution + x1] - gusts[y0 * gustResolution + x0]);
+    float gust1 = gusts[y1 * gustResolution + x0] + gfu * (gusts[y1 * gustResolution + x1] - gusts[y1 * gustResolution + x0]);
+    float gust = 1.0f + gustStrength * (gust0 + gfv * (gust1 - gust0));
+
+    return glm::vec3(wind * gust, 0.0f);
+}
+
+void WindField::sample(const glm::vec3 *positions, const int *bodies, size_t count, float time, glm::vec3 *out) const
+{
+    size_t n = 0;
+
+#ifdef WIND_FIELD_SSE2
+    const __m128 originX = _mm_set1_ps(origin.x), originY = _mm_set1_ps(origin.y);
+    const __m128 invCell = _mm_set1_ps(invCellSize);
+    const __m128 zero = _mm_setzero_ps(), maxCoord = _mm_set1_ps(resolution - 1.001f);
+    const __m128 rowSize = _mm_set1_ps(static_cast<float>(resolution));
+    const __m128 driftX = _mm_set1_ps(meanWind.x * time), driftY = _mm_set1_ps(meanWind.y * time);
+    const __m128 invGustCell = _mm_set1_ps(1.0f / gustCellSize);
+    const __m128 one = _mm_set1_ps(1.0f), gustScale = _mm_set1_ps(gustStrength);
+    const __m128i mask = _mm_set1_epi32(gustResolution - 1), oneInt = _mm_set1_epi32(1);
+
+    alignas(16) float px[4], py[4];
+    alignas(16) int cellIndex[4], gx0[4], gy0[4], gx1[4], gy1[4];
+    alignas(16) float x00[4], x10[4], x01[4], x11[4], y00[4], y10[4], y01[4], y11[4];
+    alignas(16) float g00[4], g10[4], g01[4], g11[4];
+    alignas(16) float outX[4], outY[4];
+
+    for (; n + 4 <= count; n += 4)
+    {
+        for (int k = 0; k < 4; k++)
+        {
+            const glm::vec3 &position = positions[bodies[n + k]];
+            px[k] = position.x;
+            py[k] = position.y;
+        }
+        __m128 x = _mm_load_ps(px), y = _mm_load_ps(py);
+
+        // Base grid coordinates, clamped so the truncation is a floor
+        __m128 u = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(x, originX), invCell), zero), maxCoord);
+        __m128 v = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(y, originY), invCell), zero), maxCoord);
+        __m128 iu = _mm_cvtepi32_ps(_mm_cvttps_epi32(u)), iv = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+        __m128 fu = _mm_sub_ps(u, iu), fv = _mm_sub_ps(v, iv);
+        _mm_store_si128(reinterpret_cast<__m128i *>(cellIndex), _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(iv, rowSize), iu)));
+
+        // Gust coordinates can be negative, so floor explicitly before wrapping
+        __m128 gu = _mm_mul_ps(_mm_sub_ps(x, driftX), invGustCell), gv = _mm_mul_ps(_mm_sub_ps(y, driftY), invGustCell);
+        __m128 flu = _mm_cvtepi32_ps(_mm_cvttps_epi32(gu)), flv = _mm_cvtepi32_ps(_mm_cvttps_epi32(gv));
+        flu = _mm_sub_ps(flu, _mm_and_ps(_mm_cmpgt_ps(flu, gu), one));
+        flv = _mm_sub_ps(flv, _mm_and_ps(_mm_cmpgt_ps(flv, gv), one));
+        __m128 gfu = _mm_sub_ps(gu, flu), gfv = _mm_sub_ps(gv, flv);
+        __m128i ix = _mm_cvttps_epi32(flu), iy = _mm_cvttps_epi32(flv);
+        _mm_store_si128(reinterpret_cast<__m128i *>(gx0), _mm_and_si128(ix, mask));
+        _mm_store_si128(reinterpret_cast<__m128i *>(gy0), _mm_and_si128(iy, mask));
+        _mm_store_si128(reinterpret_cast<__m128i *>(gx1), _mm_and_si128(_mm_add_epi32(ix, oneInt), mask));
+        _mm_store_si128(reinterpret_cast<__m128i *>(gy1), _mm_and_si128(_mm_add_epi32(iy, oneInt), mask));
+
+        // Gathers stay scalar, corners of a cell share cache lines
+        for (int k = 0; k < 4; k++)
+        {
+            const glm::vec2 *cell = cells.data() + cellIndex[k];
+            x00[k] = cell[0].x;
+            y00[k] = cell[0].y;
+            x10[k] = cell[1].x;
+            y10[k] = cell[1].y;
+            x01[k] = cell[resolution].x;
+            y01[k] = cell[resolution].y;
+            x11[k] = cell[resolution + 1].x;
+            y11[k] = cell[resolution + 1].y;
+
+            g00[k] = gusts[gy0[k] * gustResolution + gx0[k]];
+            g10[k] = gusts[gy0[k] * gustResolution + gx1[k]];
+            g01[k] = gusts[gy1[k] * gustResolution + gx0[k]];
+            g11[k] = gusts[gy1[k] * gustResolution + gx1[k]];
+        }
+
+        auto lerp = [](__m128 a, __m128 b, __m128 t)
+        { return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a))); };
+
+        __m128 windX = lerp(lerp(_mm_load_ps(x00), _mm_load_ps(x10), fu), lerp(_mm_load_ps(x01), _mm_load_ps(x11), fu), fv);
+        __m128 windY = lerp(lerp(_mm_load_ps(y00), _mm_load_ps(y10), fu), lerp(_mm_load_ps(y01), _mm_load_ps(y11), fu), fv);
+        __m128 gust = lerp(lerp(_mm_load_ps(g00), _mm_load_ps(g10), gfu), lerp(_mm_load_ps(g01), _mm_load_ps(g11), gfu), gfv);
+        gust = _mm_add_ps(one, _mm_mul_ps(gustScale, gust));
+
+        _mm_store_ps(outX, _mm_mul_ps(windX, gust));
+        _mm_store_ps(outY, _mm_mul_ps(windY, gust));
+        for (int k = 0; k < 4; k++)
+            out[n + k] = glm::vec3(outX[k], outY[k], 0.0f);
+    }
+#endif
+
+    for (; n < count; n++)
+        out[n] = sample(positions[bodies[n]], time);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// Wind over the course as a grid of 2D vectors, with gusts that drift downwind
+class WindField
+{
+public:
+    // Square grid of resolution x resolution cells, centred on center
+    void generate(int resolution, float cellSize, const glm::vec2 &center, const glm::vec3 &direction, float strength, uint32_t seed = 1);
+    void clear();
+    bool empty() const { return cells.empty(); }
+
+    // Wind at the positions of bodies[0..count), batched four at a time
+    void sample(const glm::vec3 *positions, const int *bodies, size_t count, float time, glm::vec3 *out) const;
+    glm::vec3 sample(const glm::vec3 &position, float time) const;
+
+    // Gusts scale the base wind by up to this fraction
+    float gustStrength = 0.3f;
+
+private:
+    int resolution = 0;
+    float cellSize = 1.0f;
+    float invCellSize = 1.0f;
+    glm::vec2 origin = glm::vec2(0.0f);
+    glm::vec2 meanWind = glm::vec2(0.0f);
+    std::vector<glm::vec2> cells;
+
+    // Small tiling grid of gust factors, carried along by the mean wind
+    static constexpr int gustResolution = 64;
+    static constexpr float gustCellSize = 8.0f;
+    std::vector<float> gusts;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Linear allocator for data that lives as long as one prepared frame
+// Offsets stay valid when the storage grows, so commands keep offsets and resolve them when drawing
+class FrameArena
+{
+public:
+    template <typename T>
+    uint32_t allocate(size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Frame arena only holds trivially copyable data");
+
+        size_t offset = (used + alignof(T) - 1) & ~(alignof(T) - 1);
+        used = offset + count * sizeof(T);
+
+        // Only grows until the largest frame fits, after that reset keeps the storage
+        if (used > storage.size())
+            storage.resize(std::max(used, 2 * storage.size()));
+
+        return static_cast<uint32_t>(offset);
+    }
+
+    template <typename T>
+    T *get(uint32_t offset) { return reinterpret_cast<T *>(storage.data() + offset); }
+
+    template <typename T>
+    const T *get(uint32_t offset) const { return reinterpret_cast<const T *>(storage.data() + offset); }
+
+    void reset() { used = 0; }
+
+    // Bytes handed out since the last reset
+    size_t size() const { return used; }
+
+private:
+    std::vector<std::byte> storage;
+    size_t used = 0;
+};
@@ -0,0 +1,100 @@
+#include "render/frustum.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FRUSTUM_SSE2 1
+#endif
+
+void SphereSet::clear()
+{
+    x.clear();
+    y.clear();
+    z.clear();
+    radius.clear();
+}
+
+void SphereSet::push(const glm::vec3 &center, float r)
+{
+    x.push_back(center.x);
+    y.push_back(center.y);
+    z.push_back(center.z);
+    radius.push_back(r);
+}
+
+Frustum Frustum::fromViewProjection(const glm::mat4 &viewProjection)
+{
+    // Rows of the matrix, glm stores columns
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; i++)
+        rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+
+    Frustum frustum;
+    frustum.planes[0] = rows[3] + rows[0]; // Left
+    frustum.planes[1] = rows[3] - rows[0]; // Right
+    frustum.planes[2] = rows[3] + rows[1]; // Bottom
+    frustum.planes[3] = rows[3] - rows[1]; // Top
+    frustum.planes[4] = rows[3] + rows[2]; // Near
+    frustum.planes[5] = rows[3] - rows[2]; // Far
+
+    // Unit normals, so plane distances compare directly with radii
+    for (int p = 0; p < frustum.planeCount; p++)
+        frustum.planes[p] /= glm::length(glm::vec3(frustum.planes[p]));
+
+    return frustum;
+}
+
+void Frustum::addPlane(const glm::vec4 &plane)
+{
+    if (planeCount < maxPlanes)
+        planes[planeCount++] = plane;
+}
+
+bool Frustum::intersects(const glm::vec3 &center, float radius) const
+{
+    for (int p = 0; p < planeCount; p++)
+        if (glm::dot(glm::vec3(planes[p]), center) + planes[p].w < -radius)
+            return false;
+    return true;
+}
+
+void Frustum::markVisible(const SphereSet &spheres, uint8_t *visible) const
+{
+    size_t count = spheres.size();
+    size_t n = 0;
+
+#ifdef FRUSTUM_SSE2
+    __m128 planeX[maxPlanes], planeY[maxPlanes], planeZ[maxPlanes], planeW[maxPlanes];
+    for (int p = 0; p < planeCount; p++)
+    {
+        planeX[p] = _mm_set1_ps(planes[p].x);
+        planeY[p] = _mm_set1_ps(planes[p].y);
+        planeZ[p] = _mm_set1_ps(planes[p].z);
+        planeW[p] = _mm_set1_ps(planes[p].w);
+    }
+
+    for (; n + 4 <= count; n += 4)
+    {
+        __m128 x = _mm_loadu_ps(spheres.x.data() + n), y = _mm_loadu_ps(spheres.y.data() + n);
+        __m128 z = _mm_loadu_ps(spheres.z.data() + n);
+        __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(spheres.radius.data() + n));
+
+        // A sphere is out once it is fully behind any plane
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < planeCount; p++)
+        {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], x), _mm_mul_ps(planeY[p], y)),
+                                         _mm_add_ps(_mm_mul_ps(planeZ[p], z), planeW[p]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        for (int k = 0; k < 4; k++)
+            if (mask & (1 << k))
+                visible[n + k] = 1;
+    }
+#endif
+
+    for (; n < count; n++)
+        if (intersects(glm::vec3(spheres.x[n], spheres.y[n], spheres.z[n]), spheres.radius[n]))
+            visible[n] = 1;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// World space bounding spheres, one array per component so they can be tested four at a time
+struct SphereSet
+{
+    std::vector<float> x, y, z, radius;
+
+    void clear();
+    void push(const glm::vec3 &center, float r);
+    size_t size() const { return radius.size(); }
+};
+
+// View frustum as six planes with inward normals, plus any clip planes of the view
+struct Frustum
+{
+    static constexpr int maxPlanes = 8;
+    glm::vec4 planes[maxPlanes];
+    int planeCount = 6;
+
+    static Frustum fromViewProjection(const glm::mat4 &viewProjection);
+
+    // Keeps the side the normal points to, the normal must be unit length
+    void addPlane(const glm::vec4 &plane);
+
+    // Sets visible[i] for every sphere that is at least partly inside, others are left as they are
+    void markVisible(const SphereSet &spheres, uint8_t *visible) const;
+    bool intersects(const glm::vec3 &center, float radius) const;
+};
@@ -1,13 +1,28 @@
 #include "render/render.hpp"
 
 #include "pch.h"
+#include "animation/matrix_batch.hpp"
 
+#include "render/frustum.hpp"
+#include "render/stream_buffer.hpp"
 #include "ui_manager/ui_manager_defs.h"
 
-// Text
-unsigned int textVAO, textVBO;
+#include <cstddef>
+#include <cstring>
+
+// Text, the glyph quads of every renderText call are collected and drawn together
+struct TextVertex
+{
+    glm::vec4 vertex; // Position and texture coordinates
+    glm::vec4 color;
+};
+unsigned int textVAO;
+unsigned int textVAOBuffer = 0; // Stream buffer the text attributes point into
 unsigned int textTexture;
-std::map<GLchar, Character> Characters;
+std::array<Character, 128> glyphs{};
+float glyphHeight = 0.0f; // Height of 'H', lines are placed and spaced by it
+std::vector<TextVertex> textVertices;
+int textDrawCount = 0, textGlyphCount = 0;
 std::string fontpath = "resources/fonts/MusticaPro-SemiBold.otf";
 float textTextureSize = 128;
 
@@ -22,6 +37,10 @@ unsigned int copyFBO;
 // Clipping and culling
 glm::vec4 clipPlane(0, 0, 0, 0);
 
+// Per frame streams, instances, text and frame uniforms share one, the bone palette texture covers a whole buffer so it has its own
+StreamBuffer frameStream, boneStream;
+int uniformAlignment = 256;
+
 // Quad for rendering
 unsigned int quadVAO = 0, quadVBO = 0;
 float quadVertices[] = {0};
@@ -34,120 +53,187 @@ float waterTimer = 0.0f;
 // Debug
 glm::vec3 debugColor(1.0f, 0.1f, 0.1f);
 float FPS = 0.0f;
+Telemetry::Frame physicsTelemetry;
+
+// Culling, bounds and visibility of every scene item in every pass, kept between frames
+SphereSet itemSpheres;
+std::array<std::vector<uint8_t>, renderPassCount> passVisible;
+std::vector<int> modelLods;
+const float animatedBoundsMargin = 1.5f; // Animated parts swing around their bones, out of the bind pose bounds
+const int waterLodBias = 1;              // Models in the water passes use this many LODs coarser
+
+// Command slot of each item in each pass, arena data of each model, and sort scratch space, kept between frames
+std::array<std::vector<int>, renderPassCount> passSlots;
+std::vector<int> visibleItems;
+std::vector<uint32_t> modelTextureLayers, modelBoneTransforms;
+std::vector<std::pair<uint64_t, uint32_t>> sortKeys, sortScratch;
+std::vector<RenderCommand> sortedCommands;
+
+#ifdef MARAMA_CHECK_PREP_ALLOCATIONS
+// Largest frame each buffer has been prepared for in the current scene, a prep that fits in it has nothing to grow
+struct PrepPeak
+{
+    const Scene *scene = nullptr;
+    int itemCount = 0;
+    int slotCounts[renderPassCount] = {};
+    size_t arenaSize = 0;
+};
+std::array<PrepPeak, std::tuple_size_v<decltype(Render::renderBuffers)>> prepPeaks;
+#endif
+
+// Instancing, model commands sharing meshes and shader are drawn in one call
+struct InstanceBatch
+{
+    int command; // Command whose meshes and textures the batch uses
+    int first;   // First instance in instanceData
+    int count;
+};
+
+StreamSlice instanceSlice;
+unsigned int bonePaletteBuffer = 0, bonePaletteTexture = 0;
+const int bonePaletteUnit = 4;
+
+struct PassBatches
+{
+    std::vector<InstanceBatch> batches;
+    std::vector<int> commandBatch; // Batch drawn at each command, -1 if it is drawn elsewhere
+};
+
+std::vector<InstanceData> instanceData;
+std::array<PassBatches, renderPassCount> passBatches;
+std::vector<int> instanceBatchOf; // Batch every model command belongs to
 
 // Track current and last used shader
 Shader *shader;
 Shader *lastShader = nullptr;
 
-void renderModel(const RenderCommand &cmd)
+// GL state inside renderObjects, only actual changes reach the driver
+struct StateCache
 {
-    // Send general shader data
-    if (shader != lastShader)
-    {
-        // Set texture array index
-        shader->setInt("textureArray", cmd.textureUnit);
+    int blend = -1, cull = -1;
+    GLenum polygonMode = 0;
+    unsigned int textures[4] = {0, 0, 0, 0};
+};
+StateCache state;
+RenderStats stats;
+
+void resetStateCache()
+{
+    // Code outside renderObjects changes state directly, so nothing is assumed at the start of a pass
+    state = StateCache();
+    state.textures[1] = state.textures[2] = state.textures[3] = ~0u;
+    MeshUtil::invalidateVertexArray();
+}
 
-        // Send light and view position to shader
-        shader->setVec3("lightPos", SceneManager::currentScene.get()->lightPos);
-        shader->setVec3("viewPos", Camera::getPosition());
-        shader->setFloat("lightIntensity", SceneManager::currentScene.get()->lightInsensity);
-        shader->setVec3("lightCol", SceneManager::currentScene.get()->lightCol);
+void setBlend(bool enabled)
+{
+    if (state.blend == static_cast<int>(enabled))
+        return;
 
-        // Apply view and projection to whole scene
-        shader->setMat4("u_view", Camera::u_view);
-        shader->setMat4("u_projection", Camera::u_projection);
+    if (enabled)
+    {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+    else
+        glDisable(GL_BLEND);
 
-        // Set clipping plane
-        shader->setVec4("location_plane", clipPlane);
+    state.blend = enabled;
+    stats.stateToggles++;
+}
 
-        lastShader = shader;
-    }
+void setCullFace(bool enabled)
+{
+    if (state.cull == static_cast<int>(enabled))
+        return;
 
-    // Send model specific data
-    shader->setMat4("u_model", cmd.modelMatrix);
-    shader->setMat4("u_normal", cmd.normalMatrix);
+    if (enabled)
+        glEnable(GL_CULL_FACE);
+    else
+        glDisable(GL_CULL_FACE);
 
-    shader->setIntArray("textureLayers", cmd.textureLayers.data(), cmd.textureLayers.size());
+    state.cull = enabled;
+    stats.stateToggles++;
+}
 
-    shader->setBool("animated", cmd.animated);
+void setPolygonMode(GLenum mode)
+{
+    if (state.polygonMode == mode)
+        return;
 
-    shader->setVec3("bodyColor", cmd.color);
+    glPolygonMode(GL_FRONT_AND_BACK, mode);
+    state.polygonMode = mode;
+    stats.stateToggles++;
+}
 
-    if (cmd.animated)
-    {
-        shader->setMat4Array("u_boneTransforms", cmd.boneTransforms);
-        shader->setMat4Array("u_inverseOffsets", cmd.boneInverseOffsets);
-    }
+void bindTexture(int unit, unsigned int texture)
+{
+    if (state.textures[unit] == texture)
+        return;
 
-    // Draw meshes
-    for (auto &mesh : *cmd.meshes)
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    state.textures[unit] = texture;
+    stats.textureBinds++;
+}
+
+void drawMeshes(const RenderCommand &cmd)
+{
+    for (int m = 0; m < cmd.meshCount; m++)
     {
         std::visit([](auto &actualMesh)
                    { actualMesh.draw(); },
-                   mesh);
+                   cmd.meshes[m]);
+        stats.drawCalls++;
     }
 }
 
-void renderHitbox(const RenderCommand &cmd)
+void renderModelBatch(const RenderCommand &cmd, const InstanceBatch &batch, const FrameArena &arena)
 {
-    if (WaterPass)
-        return;
-
-    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-    glDisable(GL_CULL_FACE);
-
     // Send general shader data
     if (shader != lastShader)
     {
-        // Apply view and projection to whole scene
-        shader->setMat4("u_view", Camera::u_view);
-        shader->setMat4("u_projection", Camera::u_projection);
-
-        // Set clipping plane
-        shader->setVec4("location_plane", clipPlane);
+        // Set texture array index
+        shader->setInt(Uniforms::textureArray, cmd.textureUnit);
+        shader->setInt(Uniforms::u_bonePalette, bonePaletteUnit);
 
         lastShader = shader;
     }
 
-    // Send model specific data
-    shader->setMat4("u_model", cmd.modelMatrix);
-
-    shader->setBool("animated", cmd.animated);
-
-    shader->setVec3("bodyColor", cmd.color);
+    // Shared by every instance of the model, transforms and colors come from the instance buffer
+    shader->setIntArray(Uniforms::textureLayers, arena.get<int>(cmd.textureLayers), cmd.textureLayerCount);
 
     // Draw meshes
-    for (auto &mesh : *cmd.meshes)
+    size_t instanceOffset = instanceSlice.offset + batch.first * sizeof(InstanceData);
+    for (int m = 0; m < cmd.meshCount; m++)
     {
-        std::visit([](auto &actualMesh)
-                   { actualMesh.draw(); },
-                   mesh);
-    }
-
-    if (!SettingsManager::settings.debug.wireframeMode)
-    {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        glEnable(GL_CULL_FACE);
+        std::visit([&](auto &actualMesh)
+                   { actualMesh.drawInstanced(instanceSlice.buffer, instanceOffset, batch.count); },
+                   cmd.meshes[m]);
+        stats.drawCalls++;
     }
 }
 
-void renderOpaquePlane(const RenderCommand &cmd)
+void renderHitbox(const RenderCommand &cmd)
 {
-    if (shader != lastShader)
-    {
-        // Apply view and projection to whole scene
-        shader->setMat4("u_view", Camera::u_view);
-        shader->setMat4("u_projection", Camera::u_projection);
+    if (WaterPass)
+        return;
 
-        // Clipping Plane
-        shader->setVec4("location_plane", clipPlane);
+    // Send model specific data
+    shader->setMat4(Uniforms::u_model, cmd.modelMatrix);
 
-        lastShader = shader;
-    }
+    shader->setBool(Uniforms::animated, cmd.animated);
+
+    shader->setVec3(Uniforms::bodyColor, cmd.color);
 
+    drawMeshes(cmd);
+}
+
+void renderOpaquePlane(const RenderCommand &cmd)
+{
     // Set model matrix for model and draw
-    shader->setMat4("u_model", cmd.modelMatrix);
-    shader->setMat4("u_normal", cmd.normalMatrix);
+    shader->setMat4(Uniforms::u_model, cmd.modelMatrix);
+    shader->setMat4(Uniforms::u_normal, cmd.normalMatrix);
 
     if (cmd.shader == shaderID::ToonWater)
     {
@@ -155,43 +241,21 @@ void renderOpaquePlane(const RenderCommand &cmd)
         int normalMap = TextureManager::getStandaloneTextureUnit("resources/textures/waterNormal.png");
         int heightmap = TextureManager::getStandaloneTextureUnit("resources/textures/heightmap.jpg");
 
-        shader->setInt("toonWater", toonWater);
-        shader->setInt("normalMap", normalMap);
-        shader->setInt("heightmap", heightmap);
+        shader->setInt(Uniforms::toonWater, toonWater);
+        shader->setInt(Uniforms::normalMap, normalMap);
+        shader->setInt(Uniforms::heightmap, heightmap);
 
-        shader->setFloat("moveOffset", TimeManager::time);
-        shader->setMat4("u_camXY", Camera::u_camXY);
+        shader->setFloat(Uniforms::moveOffset, TimeManager::time);
     }
 
-    // Draw meshes
-    for (auto &mesh : *cmd.meshes)
-    {
-        std::visit([](auto &actualMesh)
-                   { actualMesh.draw(); },
-                   mesh);
-    }
+    drawMeshes(cmd);
 }
 
 void renderTransparentPlane(const RenderCommand &cmd)
 {
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    if (shader != lastShader)
-    {
-        // Apply view and projection to whole scene
-        shader->setMat4("u_view", Camera::u_view);
-        shader->setMat4("u_projection", Camera::u_projection);
-
-        // Clipping Plane
-        shader->setVec4("location_plane", clipPlane);
-
-        lastShader = shader;
-    }
-
     // Set model matrix for model and draw
-    shader->setMat4("u_model", cmd.modelMatrix);
-    shader->setMat4("u_normal", cmd.normalMatrix);
+    shader->setMat4(Uniforms::u_model, cmd.modelMatrix);
+    shader->setMat4(Uniforms::u_normal, cmd.normalMatrix);
 
     if (cmd.shader == shaderID::Water)
     {
@@ -200,103 +264,204 @@ void renderTransparentPlane(const RenderCommand &cmd)
         int dudv = TextureManager::getTextureLayerIndex("waterTextureArray", "resources/textures/waterDUDV.png");
         int normal = TextureManager::getTextureLayerIndex("waterTextureArray", "resources/textures/waterNormal.png");
 
-        shader->setInt("waterTextureArray", waterTexArrayID);
-        shader->setInt("dudvMapLayer", dudv);
-        shader->setInt("normalMapLayer", normal);
+        shader->setInt(Uniforms::waterTextureArray, waterTexArrayID);
+        shader->setInt(Uniforms::dudvMapLayer, dudv);
+        shader->setInt(Uniforms::normalMapLayer, normal);
 
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, FramebufferUtil::reflectionFBO.colorTexture);
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, FramebufferUtil::refractionFBO.colorTexture);
-        glActiveTexture(GL_TEXTURE3);
-        glBindTexture(GL_TEXTURE_2D, FramebufferUtil::refractionFBO.depthTexture);
-
-        shader->setInt("reflectionTexture", 1);
-        shader->setInt("refractionTexture", 2);
-        shader->setInt("depthMap", 3);
-        shader->setFloat("moveOffset", TimeManager::time);
-        shader->setVec3("cameraPosition", Camera::getPosition());
-        shader->setVec3("lightPos", SceneManager::currentScene.get()->lightPos);
-        shader->setVec3("lightCol", SceneManager::currentScene.get()->lightCol);
-        shader->setMat4("u_camXY", Camera::u_camXY);
+        bindTexture(1, FramebufferUtil::reflectionFBO.colorTexture);
+        bindTexture(2, FramebufferUtil::refractionFBO.colorTexture);
+        bindTexture(3, FramebufferUtil::refractionFBO.depthTexture);
+
+        shader->setInt(Uniforms::reflectionTexture, 1);
+        shader->setInt(Uniforms::refractionTexture, 2);
+        shader->setInt(Uniforms::depthMap, 3);
+        shader->setFloat(Uniforms::moveOffset, TimeManager::time);
     }
 
     // Draw meshes
     if (cmd.shader == shaderID::Water && !WaterPass)
-    {
-        for (auto &mesh : *cmd.meshes)
-        {
-            std::visit([](auto &actualMesh)
-                       { actualMesh.draw(); },
-                       mesh);
-        }
-    }
-
-    glDisable(GL_BLEND);
+        drawMeshes(cmd);
 }
 
 void renderGrid(const RenderCommand &cmd)
 {
     if (shader != lastShader)
     {
-        // Apply view and projection to whole scene
-        shader->setMat4("u_view", Camera::u_view);
-        shader->setMat4("u_projection", Camera::u_projection);
-
-        shader->setVec3("lightPos", SceneManager::currentScene.get()->lightPos);
-        shader->setVec3("lightCol", SceneManager::currentScene.get()->lightCol);
-
-        // Clipping Plane
-        shader->setVec4("location_plane", clipPlane);
-
         int heightmap = TextureManager::getStandaloneTextureUnit("resources/textures/heightmap.jpg");
-        shader->setInt("heightmap", heightmap);
+        shader->setInt(Uniforms::heightmap, heightmap);
 
         unsigned int sandTexArrayID = TextureManager::getTextureArrayUnit("sandTextureArray");
-        shader->setInt("sandTextureArray", sandTexArrayID);
-
-        shader->setMat4("u_camXY", Camera::u_camXY);
+        shader->setInt(Uniforms::sandTextureArray, sandTexArrayID);
 
         lastShader = shader;
     }
 
     // Set model matrix for model and draw
-    shader->setMat4("u_model", cmd.modelMatrix);
-    shader->setMat4("u_normal", cmd.normalMatrix);
+    shader->setMat4(Uniforms::u_model, cmd.modelMatrix);
+    shader->setMat4(Uniforms::u_normal, cmd.normalMatrix);
 
-    shader->setFloat("lod", cmd.lod);
+    shader->setFloat(Uniforms::lod, cmd.lod);
 
-    // Draw meshes
-    for (auto &mesh : *cmd.meshes)
-    {
-        std::visit([](auto &actualMesh)
-                   { actualMesh.draw(); },
-                   mesh);
-    }
+    drawMeshes(cmd);
 }
 
-void renderObjects(std::vector<RenderCommand> &renderBuffer)
+void initStreams()
 {
+    frameStream.init(1 << 20);
+    boneStream.init(256 << 10);
+
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+}
+
+void initInstancing()
+{
+    // Bone palette is read as a buffer texture, one RGBA texel per matrix column, it follows the bone stream
+    glGenTextures(1, &bonePaletteTexture);
+}
 
-    if (SettingsManager::settings.debug.wireframeMode)
+// Upload the current camera and clip plane, once per view instead of once per program
+void updateFrameUniforms()
+{
+    FrameUniforms frame;
+    frame.view = Camera::u_view;
+    frame.projection = Camera::u_projection;
+    frame.camXY = Camera::u_camXY;
+    frame.clipPlane = clipPlane;
+    frame.viewPos = Camera::framePosition;
+    frame.lightIntensity = SceneManager::currentScene.get()->lightInsensity;
+    frame.lightPos = SceneManager::currentScene.get()->lightPos;
+    frame.lightCol = SceneManager::currentScene.get()->lightCol;
+
+    StreamSlice slice = frameStream.upload(&frame, sizeof(FrameUniforms), uniformAlignment);
+    glBindBufferRange(GL_UNIFORM_BUFFER, Shader::frameDataBinding, slice.buffer, slice.offset, sizeof(FrameUniforms));
+    stats.frameUniformUpdates++;
+}
+
+// Group model commands of each pass by meshes and shader, then upload all instances and bone transforms once for every pass
+void buildInstanceBatches(const ::RenderBuffer &renderBuffer)
+{
+    instanceData.clear();
+
+    // Prep put every bone transform in one block, it goes up as it is
+    int boneTexelBase = 0;
+    if (renderBuffer.boneBlockCount > 0)
     {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-        glDisable(GL_CULL_FACE);
+        StreamSlice bones = boneStream.upload(renderBuffer.arena.get<glm::mat4>(renderBuffer.boneBlock), renderBuffer.boneBlockCount * sizeof(glm::mat4), sizeof(glm::vec4));
+        boneTexelBase = static_cast<int>(bones.offset / sizeof(glm::vec4));
+
+        // The texture only has to follow the stream when it moved to a larger buffer
+        if (bones.buffer != bonePaletteBuffer)
+        {
+            bonePaletteBuffer = bones.buffer;
+            glBindTexture(GL_TEXTURE_BUFFER, bonePaletteTexture);
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, bonePaletteBuffer);
+            glBindTexture(GL_TEXTURE_BUFFER, 0);
+        }
     }
-    else
+
+    for (int pass = 0; pass < renderPassCount; pass++)
     {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        glEnable(GL_CULL_FACE);
+        const std::vector<RenderCommand> &commands = renderBuffer.commandBuffers[pass];
+        std::vector<InstanceBatch> &batches = passBatches[pass].batches;
+        std::vector<int> &commandBatch = passBatches[pass].commandBatch;
+
+        batches.clear();
+        commandBatch.assign(commands.size(), -1);
+
+        // Count instances, the same model at the same LOD has the same mesh list
+        // Commands are sorted by shader, texture and vertex array, so a model only ever continues the last batch
+        instanceBatchOf.assign(commands.size(), -1);
+        for (size_t i = 0; i < commands.size(); i++)
+        {
+            const RenderCommand &cmd = commands[i];
+            if (cmd.type != RenderType::Model)
+                continue;
+
+            int batch = static_cast<int>(batches.size()) - 1;
+            if (batch < 0 || commands[batches[batch].command].meshes != cmd.meshes || commands[batches[batch].command].shader != cmd.shader)
+            {
+                batch = static_cast<int>(batches.size());
+                batches.push_back({static_cast<int>(i), 0, 0});
+                commandBatch[i] = batch;
+            }
+
+            batches[batch].count++;
+            instanceBatchOf[i] = batch;
+        }
+
+        // Instances of a batch are contiguous, after those of the earlier passes
+        int instanceCount = static_cast<int>(instanceData.size());
+        for (InstanceBatch &batch : batches)
+        {
+            batch.first = instanceCount;
+            instanceCount += batch.count;
+            batch.count = 0;
+        }
+
+        instanceData.resize(instanceCount);
+
+        for (size_t i = 0; i < commands.size(); i++)
+        {
+            if (instanceBatchOf[i] < 0)
+                continue;
+
+            const RenderCommand &cmd = commands[i];
+            InstanceBatch &batch = batches[instanceBatchOf[i]];
+            InstanceData &instance = instanceData[batch.first + batch.count++];
+
+            instance.model = cmd.modelMatrix;
+            instance.normal = cmd.normalMatrix;
+            instance.color = cmd.color;
+            instance.boneOffset = -1;
+
+            // Texel offset into the bone stream, four texels per matrix
+            if (cmd.animated && cmd.boneCount > 0)
+                instance.boneOffset = boneTexelBase + static_cast<int>(4 * ((cmd.boneTransforms - renderBuffer.boneBlock) / sizeof(glm::mat4)));
+        }
     }
 
-    for (const RenderCommand &cmd : renderBuffer)
+    if (!instanceData.empty())
+        instanceSlice = frameStream.upload(instanceData.data(), instanceData.size() * sizeof(InstanceData), sizeof(glm::vec4));
+
+    glActiveTexture(GL_TEXTURE0 + bonePaletteUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, bonePaletteTexture);
+}
+
+void renderObjects(const ::RenderBuffer &renderBuffer, RenderPass pass)
+{
+    bool wireframe = SettingsManager::settings.debug.wireframeMode;
+    resetStateCache();
+
+    const std::vector<RenderCommand> &commands = renderBuffer.commandBuffers[static_cast<int>(pass)];
+    const PassBatches &batches = passBatches[static_cast<int>(pass)];
+
+    for (size_t i = 0; i < commands.size(); i++)
     {
+        const RenderCommand &cmd = commands[i];
+
+        // Models merged into an earlier command's batch are already drawn
+        if (cmd.type == RenderType::Model && batches.commandBatch[i] < 0)
+            continue;
+
         shader = ShaderUtil::load(cmd.shader);
 
+        // Commands are sorted by pass, so these only change at pass boundaries
+        if (cmd.type == RenderType::Hitbox)
+        {
+            setPolygonMode(GL_LINE);
+            setCullFace(false);
+        }
+        else
+        {
+            setPolygonMode(wireframe ? GL_LINE : GL_FILL);
+            setCullFace(!wireframe);
+        }
+        setBlend(cmd.type == RenderType::TransparentPlane);
+
         switch (cmd.type)
         {
         case RenderType::Model:
-            renderModel(cmd);
+            renderModelBatch(cmd, batches.batches[batches.commandBatch[i]], renderBuffer.arena);
             break;
 
         case RenderType::Hitbox:
@@ -317,8 +482,11 @@ void renderObjects(std::vector<RenderCommand> &renderBuffer)
         }
     }
 
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-    glEnable(GL_CULL_FACE);
+    setPolygonMode(GL_FILL);
+    setCullFace(true);
+    setBlend(false);
+    glBindVertexArray(0);
+    MeshUtil::invalidateVertexArray();
 }
 
 void renderSceneSkyBox()
@@ -337,12 +505,10 @@ void renderSceneSkyBox()
         glActiveTexture(GL_TEXTURE1);
         glBindTexture(GL_TEXTURE_CUBE_MAP, SceneManager::currentScene.get()->skyBox.textureID);
 
-        // Set view matrices
-        shader->setMat4("u_view", glm::mat4(glm::mat3(Camera::u_view)));
-        shader->setMat4("u_projection", Camera::u_projection);
-        shader->setMat4("u_model", glm::mat4(1.0f));
+        // View and projection come from the frame block, the shader drops the translation
+        shader->setMat4(Uniforms::u_model, glm::mat4(1.0f));
 
-        shader->setInt("skybox", 1);
+        shader->setInt(Uniforms::skybox, 1);
 
         lastShader = shader;
 
@@ -357,6 +523,57 @@ void renderSceneSkyBox()
     }
 }
 
+// Draw all text queued since the last flush in one call, the atlas is the only font texture
+void flushText()
+{
+    if (textVertices.empty())
+        return;
+
+    shader = ShaderUtil::load(shaderID::Text);
+
+    if (shader != lastShader || WindowManager::windowSizeChanged)
+    {
+        // Set the projection matrix for the text shader
+        glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(WindowManager::screenWidth), static_cast<float>(WindowManager::screenHeight), 0.0f);
+        shader->setMat4(Uniforms::projection, projection);
+
+        lastShader = shader;
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textTexture);
+
+    // Whole vertices from the start of the buffer, so the draw can start at the slice
+    StreamSlice slice = frameStream.upload(textVertices.data(), textVertices.size() * sizeof(TextVertex), sizeof(TextVertex));
+
+    glBindVertexArray(textVAO);
+    if (slice.buffer != textVAOBuffer)
+    {
+        // Position and texture coordinates, then color
+        glBindBuffer(GL_ARRAY_BUFFER, slice.buffer);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void *)offsetof(TextVertex, vertex));
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void *)offsetof(TextVertex, color));
+        glEnableVertexAttribArray(1);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        textVAOBuffer = slice.buffer;
+    }
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glDrawArrays(GL_TRIANGLES, static_cast<GLint>(slice.offset / sizeof(TextVertex)), static_cast<GLsizei>(textVertices.size()));
+
+    textDrawCount++;
+    textGlyphCount += static_cast<int>(textVertices.size() / 6);
+    textVertices.clear();
+
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_BLEND);
+}
+
 void renderSceneTexts()
 {
     for (auto text : SceneManager::currentScene.get()->texts)
@@ -367,6 +584,9 @@ void renderSceneTexts()
 
 void renderImage(const std::string &fileName, const glm::vec2 &position, const float width, const float height, const float alpha = 1.0f, const glm::vec2 scale = {1.0, 1.0f}, const bool uniformScaling = false, const float rotation = 0.0f, const bool mirrored = false)
 {
+    // Text queued so far stays below the image
+    flushText();
+
     shader = ShaderUtil::load(shaderID::Image);
     lastShader = shader;
 
@@ -375,11 +595,11 @@ void renderImage(const std::string &fileName, const glm::vec2 &position, const f
 
     glBindVertexArray(quadVAO);
 
-    shader->setVec2("uScreenSize", glm::vec2(WindowManager::screenWidth, WindowManager::screenHeight));
+    shader->setVec2(Uniforms::uScreenSize, glm::vec2(WindowManager::screenWidth, WindowManager::screenHeight));
     glm::vec2 screenSize = glm::vec2(WindowManager::screenWidth, WindowManager::screenHeight);
 
     unsigned int textureUnit = TextureManager::getStandaloneTextureUnit("resources/images/" + fileName);
-    shader->setInt("uTexture", textureUnit);
+    shader->setInt(Uniforms::uTexture, textureUnit);
 
     glm::vec2 posFactor = position; // normalized 0..1
 
@@ -404,13 +624,13 @@ void renderImage(const std::string &fileName, const glm::vec2 &position, const f
     positionPx.x = posFactor.x * (scaledScreenSize.x - imageSizePx.x);
     positionPx.y = posFactor.y * (scaledScreenSize.y - imageSizePx.y);
 
-    shader->setVec2("uPosition", positionPx);
+    shader->setVec2(Uniforms::uPosition, positionPx);
 
-    shader->setVec2("uImageSize", glm::vec2(width, height));
-    shader->setVec2("uScale", userScale);
-    shader->setFloat("uAlpha", alpha);
-    shader->setFloat("uRotation", glm::radians(rotation));
-    shader->setBool("uMirrored", mirrored);
+    shader->setVec2(Uniforms::uImageSize, glm::vec2(width, height));
+    shader->setVec2(Uniforms::uScale, userScale);
+    shader->setFloat(Uniforms::uAlpha, alpha);
+    shader->setFloat(Uniforms::uRotation, glm::radians(rotation));
+    shader->setBool(Uniforms::uMirrored, mirrored);
 
     glDrawArrays(GL_TRIANGLES, 0, 6);
 
@@ -427,39 +647,52 @@ void renderSceneImages()
     }
 }
 
-void renderReflectRefract(std::vector<RenderCommand> &renderBuffer)
+// Water passes keep what is above or below the surface, the same planes cull their command lists
+glm::vec4 reflectionClipPlane()
+{
+    return glm::vec4(0, 0, 1, -waterHeight);
+}
+
+glm::vec4 refractionClipPlane()
+{
+    return glm::vec4(0, 0, -1, waterHeight);
+}
+
+void renderReflectRefract(const ::RenderBuffer &renderBuffer)
 {
     // ===== REFLECTOIN =====
     // Bind reflection buffer
     FramebufferUtil::bindFrameBuffer(FramebufferUtil::reflectionFBO);
 
-    clipPlane = {0, 0, 1, -waterHeight};
-    Camera::setCamDirection(glm::vec3(-Camera::getRotation()[0], Camera::getRotation()[1], Camera::getRotation()[2]));
-    float distance = 2 * (Camera::getPosition()[2] - waterHeight);
-    Camera::genViewMatrix(Camera::getPosition() + glm::vec3(0, 0, -distance));
+    clipPlane = reflectionClipPlane();
+    Camera::setCamDirection(glm::vec3(-Camera::frameRotation[0], Camera::frameRotation[1], Camera::frameRotation[2]));
+    float distance = 2 * (Camera::framePosition[2] - waterHeight);
+    Camera::genViewMatrix(Camera::framePosition + glm::vec3(0, 0, -distance));
+    updateFrameUniforms();
 
     // Draw to it
     glClear(GL_COLOR_BUFFER_BIT);
     glClear(GL_DEPTH_BUFFER_BIT);
     renderSceneSkyBox();
     glEnable(GL_CLIP_DISTANCE0);
-    renderObjects(renderBuffer);
+    renderObjects(renderBuffer, RenderPass::Reflection);
     glDisable(GL_CLIP_DISTANCE0);
 
     // ===== REFRACTION =====
     // Bind refraction buffer
     FramebufferUtil::bindFrameBuffer(FramebufferUtil::refractionFBO);
 
-    clipPlane = {0, 0, -1, waterHeight};
-    Camera::setCamDirection(Camera::getRotation());
-    Camera::genViewMatrix(Camera::getPosition());
+    clipPlane = refractionClipPlane();
+    Camera::setCamDirection(Camera::frameRotation);
+    Camera::genViewMatrix(Camera::framePosition);
+    updateFrameUniforms();
 
     // Draw to it
     glClear(GL_COLOR_BUFFER_BIT);
     glClear(GL_DEPTH_BUFFER_BIT);
     renderSceneSkyBox();
     glEnable(GL_CLIP_DISTANCE0);
-    renderObjects(renderBuffer);
+    renderObjects(renderBuffer, RenderPass::Refraction);
     glDisable(GL_CLIP_DISTANCE0);
 
     // Unbind buffers, bind default one
@@ -475,7 +708,7 @@ void renderTestQuad(unsigned int texture, int x, int y)
     glBindTexture(GL_TEXTURE_2D, texture);
 
     Shader *quadShader = ShaderUtil::load(shaderID::Gui);
-    quadShader->setInt("screenTexture", 1);
+    quadShader->setInt(Uniforms::screenTexture, 1);
 
     // Render the quad
     glBindVertexArray(quadVAO);
@@ -582,27 +815,21 @@ void initFreeType()
             glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
             static_cast<unsigned int>(face->glyph->advance.x),
             glm::vec4(xPos / (float)atlasWidth, yPos / (float)atlasHeight, face->glyph->bitmap.width / (float)atlasWidth, face->glyph->bitmap.rows / (float)atlasHeight)};
-        Characters[c] = ch;
+        glyphs[c] = ch;
 
         // Update xPos for the next character in the atlas
         xPos += face->glyph->bitmap.width + gapX; // Add gap to x position
     }
 
+    glyphHeight = static_cast<float>(glyphs['H'].Size.y);
+
     // Now upload the entire atlas texture to OpenGL
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, atlasWidth, atlasHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, atlasData);
     delete[] atlasData; // Free the memory
     glBindTexture(GL_TEXTURE_2D, 0);
 
-    // Generate VAO and VBO for text rendering
+    // Generate VAO for text rendering, its vertices come from the frame stream
     glGenVertexArrays(1, &textVAO);
-    glGenBuffers(1, &textVBO);
-    glBindVertexArray(textVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, textVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
-
-    // Set up vertex attributes (assuming position and texture coordinates)
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)0);
-    glEnableVertexAttribArray(0);
 }
 
 void createSceneFBO(int width, int height)
@@ -640,34 +867,12 @@ void createSceneFBO(int width, int height)
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-float calculateTextWidth(const std::string &text, float scale)
-{
-    float width = 0.0f;
-    float lineWidth = 0.0f;
-
-    for (char c : text)
-    {
-        if (c == '\n')
-        {
-            width = std::max(width, lineWidth);
-            lineWidth = 0.0f;
-            continue;
-        }
-
-        if (Characters.count(c) == 0)
-            continue;
-        Character ch = Characters[c];
-        lineWidth += (ch.Advance >> 6) * scale;
-    }
-
-    width = std::max(width, lineWidth);
-    return width;
-}
-
 void Render::setup()
 {
+    initStreams();
     initQuad();
     initFreeType();
+    initInstancing();
     createSceneFBO(WindowManager::windowWidth, WindowManager::windowHeight);
 
     // Enable face culling
@@ -680,6 +885,14 @@ void Render::setup()
     glDepthFunc(GL_LESS);
 }
 
+void Render::endFrame()
+{
+    flushText();
+
+    frameStream.endFrame();
+    boneStream.endFrame();
+}
+
 void Render::resize(int width, int height)
 {
     // Delete old FBO attachments
@@ -695,6 +908,9 @@ void Render::resize(int width, int height)
 
 void Render::render()
 {
+    // Input of this frame, for the next buffer render prep starts
+    Camera::publishView();
+
     int currentIndex = renderIndex.load(std::memory_order_acquire);
     auto &buffer = renderBuffers[currentIndex];
 
@@ -722,100 +938,414 @@ void Render::render()
     }
 }
 
+// Draw order of a command, most significant first
+// Pass | shader | texture array | vertex array | depth, with depth front to back
+// Transparent planes put depth, back to front, right after the pass so blending stays correct
+uint64_t sortKey(const RenderCommand &cmd, const glm::vec3 &viewPosition)
+{
+    // Grids go after the water, its depth hides the terrain below the surface as before
+    uint64_t pass = 0;
+    switch (cmd.type)
+    {
+    case RenderType::Model:
+    case RenderType::OpaquePlane:
+        pass = 0;
+        break;
+    case RenderType::Hitbox:
+        pass = 1;
+        break;
+    case RenderType::TransparentPlane:
+        pass = 2;
+        break;
+    case RenderType::Grid:
+        pass = 3;
+        break;
+    }
+
+    // Bits of a positive float sort like the float
+    float distance = glm::distance(glm::vec3(cmd.modelMatrix[3]), viewPosition);
+    uint32_t depth;
+    std::memcpy(&depth, &distance, sizeof(depth));
+
+    uint64_t shaderBits = static_cast<uint64_t>(cmd.shader) & 0x3f;
+    uint64_t vertexArray = 0;
+    if (cmd.meshCount > 0)
+        vertexArray = std::visit([](auto &mesh)
+                                 { return static_cast<uint64_t>(mesh.VAO); },
+                                 cmd.meshes[0]) &
+                      0xffff;
+
+    if (cmd.type == RenderType::TransparentPlane)
+        return pass << 62 | static_cast<uint64_t>(~depth) << 30 | shaderBits << 24;
+
+    uint64_t texture = (cmd.type == RenderType::Model ? cmd.textureUnit : 0) & 0xff;
+    return pass << 62 | shaderBits << 56 | texture << 48 | vertexArray << 32 | depth;
+}
+
+// LSD radix sort on the keys, a byte per pass, skipping bytes that are the same for every command
+void sortCommands(std::vector<RenderCommand> &commands, const glm::vec3 &viewPosition)
+{
+    size_t count = commands.size();
+    if (count == 0)
+        return;
+
+    sortKeys.resize(count);
+    sortScratch.resize(count);
+
+    for (size_t i = 0; i < count; i++)
+        sortKeys[i] = {sortKey(commands[i], viewPosition), static_cast<uint32_t>(i)};
+
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        size_t histogram[256] = {};
+        for (const auto &key : sortKeys)
+            histogram[(key.first >> shift) & 0xff]++;
+
+        if (histogram[(sortKeys[0].first >> shift) & 0xff] == count)
+            continue;
+
+        size_t offset = 0;
+        for (size_t &bucket : histogram)
+        {
+            size_t size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+
+        for (const auto &key : sortKeys)
+            sortScratch[histogram[(key.first >> shift) & 0xff]++] = key;
+        sortKeys.swap(sortScratch);
+    }
+
+    sortedCommands.resize(count);
+    for (size_t i = 0; i < count; i++)
+        sortedCommands[i] = commands[sortKeys[i].second];
+    commands.swap(sortedCommands);
+}
+
+// Shaders that move their mesh along with the camera through u_camXY
+bool followsCamera(shaderID shader)
+{
+    return shader == shaderID::Water || shader == shaderID::ToonWater || shader == shaderID::Terrain || shader == shaderID::ToonTerrain;
+}
+
+const Bounds &meshBounds(const MeshVariant &mesh)
+{
+    return std::visit([](const auto &actualMesh) -> const Bounds &
+                      { return actualMesh.bounds; },
+                      mesh);
+}
+
+// Local sphere moved to world space, scaled by the largest axis of the transform
+void pushSphere(const Bounds &bounds, const glm::mat4 &transform, float margin)
+{
+    float scale = std::sqrt(std::max({glm::dot(glm::vec3(transform[0]), glm::vec3(transform[0])),
+                                      glm::dot(glm::vec3(transform[1]), glm::vec3(transform[1])),
+                                      glm::dot(glm::vec3(transform[2]), glm::vec3(transform[2]))}));
+    itemSpheres.push(glm::vec3(transform * glm::vec4(bounds.center, 1.0f)), bounds.radius * scale * margin);
+}
+
+// Local box moved to world space, then the sphere around it, flat planes get a much tighter sphere this way
+void pushBox(const Bounds &bounds, const glm::mat4 &transform, bool worldHeights)
+{
+    glm::vec3 localCenter = 0.5f * (bounds.min + bounds.max);
+    glm::vec3 localExtent = 0.5f * (bounds.max - bounds.min);
+
+    glm::vec3 center = glm::vec3(transform * glm::vec4(localCenter, 1.0f));
+    glm::vec3 extent(0.0f);
+    for (int axis = 0; axis < 3; axis++)
+        for (int column = 0; column < 3; column++)
+            extent[axis] += std::fabs(transform[column][axis]) * localExtent[column];
+
+    // Terrain heights are set in world space by the shader
+    if (worldHeights)
+    {
+        center.z = localCenter.z;
+        extent.z = localExtent.z;
+    }
+
+    itemSpheres.push(center, glm::length(extent));
+}
+
+int modelLod(const ModelData &model, const glm::vec3 &viewPosition)
+{
+    float distanceFromCamera = glm::distance(glm::vec3(model.u_model[3]), viewPosition);
+
+    int lod = 0;
+    if (distanceFromCamera > SettingsManager::settings.video.lodDistance)
+        lod = 1;
+    if (SceneManager::engineState == EngineState::Title)
+        lod = 0;
+
+    if (lod >= model.model->lodMeshes.size())
+        lod = static_cast<int>(model.model->lodMeshes.size()) - 1;
+
+    return lod;
+}
+
+// Mark the scene items each pass of this frame can see, items are models, opaque planes, transparent planes, then grids
+void cullScene(const Scene &scene, const ::RenderBuffer &prepBuffer, const glm::vec3 &position)
+{
+    glm::vec3 rotation = prepBuffer.view.rotation(prepBuffer.camYaw);
+    const glm::mat4 &projection = prepBuffer.view.projection;
+
+    Frustum views[renderPassCount];
+    views[static_cast<int>(RenderPass::Main)] = Frustum::fromViewProjection(projection * Camera::viewMatrix(position, Camera::directionFromRotation(rotation)));
+
+    // Reflection looks up from below the water and keeps what is above it, refraction keeps what is below the main view
+    glm::vec3 mirroredPosition = position - glm::vec3(0, 0, 2 * (position.z - waterHeight));
+    glm::vec3 mirroredRotation(-rotation[0], rotation[1], rotation[2]);
+    views[static_cast<int>(RenderPass::Reflection)] = Frustum::fromViewProjection(projection * Camera::viewMatrix(mirroredPosition, Camera::directionFromRotation(mirroredRotation)));
+    views[static_cast<int>(RenderPass::Reflection)].addPlane(reflectionClipPlane());
+
+    views[static_cast<int>(RenderPass::Refraction)] = views[static_cast<int>(RenderPass::Main)];
+    views[static_cast<int>(RenderPass::Refraction)].addPlane(refractionClipPlane());
+
+    glm::mat4 camXY = glm::translate(glm::mat4(1.0f), glm::vec3(position.x, position.y, 0.0f));
+
+    itemSpheres.clear();
+    modelLods.resize(scene.structModels.size());
+
+    for (size_t i = 0; i < scene.structModels.size(); i++)
+    {
+        const ModelData &model = scene.structModels[i];
+        modelLods[i] = modelLod(model, position);
+        pushSphere(meshBounds(model.model->lodMeshes[modelLods[i]].front()), model.u_model, model.animated ? animatedBoundsMargin : 1.0f);
+    }
+
+    for (const UnitPlaneData &plane : scene.opaqueUnitPlanes)
+        pushBox(meshBounds(plane.unitPlane), followsCamera(plane.shader) ? camXY * plane.u_model : plane.u_model, false);
+
+    for (const UnitPlaneData &plane : scene.transparentUnitPlanes)
+        pushBox(meshBounds(plane.unitPlane), followsCamera(plane.shader) ? camXY * plane.u_model : plane.u_model, false);
+
+    for (const GridData &grid : scene.grids)
+        pushBox(meshBounds(grid.grid), followsCamera(grid.shader) ? camXY * grid.u_model : grid.u_model, true);
+
+    // All spheres against every view, four at a time, the water views only exist with water in the scene
+    int passCount = ShaderUtil::waterLoaded ? renderPassCount : 1;
+    for (int pass = 0; pass < renderPassCount; pass++)
+    {
+        passVisible[pass].assign(itemSpheres.size(), 0);
+        if (pass < passCount)
+            views[pass].markVisible(itemSpheres, passVisible[pass].data());
+    }
+}
+
+#ifdef MARAMA_CHECK_PREP_ALLOCATIONS
+// Once a buffer has been prepared for a frame at least this large, preparing it again must not allocate
+void checkPrepAllocations(const ::RenderBuffer &prepBuffer, const Scene &scene, int itemCount, const int *slotCounts, long long allocations)
+{
+    PrepPeak &peak = prepPeaks[&prepBuffer - Render::renderBuffers.data()];
+
+    bool grew = peak.scene != &scene || itemCount > peak.itemCount || prepBuffer.arena.size() > peak.arenaSize;
+    for (int pass = 0; pass < renderPassCount; pass++)
+        grew = grew || slotCounts[pass] > peak.slotCounts[pass];
+
+    if (grew)
+    {
+        if (peak.scene != &scene)
+            peak = PrepPeak{};
+
+        peak.scene = &scene;
+        peak.itemCount = std::max(peak.itemCount, itemCount);
+        peak.arenaSize = std::max(peak.arenaSize, prepBuffer.arena.size());
+        for (int pass = 0; pass < renderPassCount; pass++)
+            peak.slotCounts[pass] = std::max(peak.slotCounts[pass], slotCounts[pass]);
+        return;
+    }
+
+    if (allocations > 0)
+    {
+        std::cerr << "Error: Render prep allocated " << allocations << " times for a frame its buffer already fit" << std::endl;
+        std::abort();
+    }
+}
+#endif
+
 void Render::prepareRender(::RenderBuffer &prepBuffer)
 {
-    // Clear and reserve size for buffer
-    prepBuffer.commandBuffer.clear();
-    prepBuffer.commandBuffer.reserve(
-        SceneManager::currentScene->structModels.size() +
-        SceneManager::currentScene->opaqueUnitPlanes.size() +
-        SceneManager::currentScene->transparentUnitPlanes.size() +
-        SceneManager::currentScene->grids.size());
-
-    std::vector<std::future<RenderCommand>> futures;
-
-    // Load Models
-    for (auto &model : SceneManager::currentScene->structModels)
+    // Counts this thread and the prep jobs below, whichever workers run them
+    AllocationCounter::Scope countAllocations;
+    long long allocationsBefore = AllocationCounter::counted();
+
+    Scene &scene = *SceneManager::currentScene;
+    bool showHitboxes = SettingsManager::settings.debug.showHitboxes;
+
+    // The buffer is free again, everything from its last frame can go
+    prepBuffer.arena.reset();
+
+    // Camera follows the controlled model
+    for (ModelData &model : scene.structModels)
     {
-        futures.push_back(std::async(std::launch::async, [&model]()
-                                     {
-            RenderCommand cmd;
-            
+        if (model.controlled && model.bonePalette && model.model->yachtBones.cam >= 0)
+        {
+            prepBuffer.camPos = (model.u_model * model.bonePalette->read()[model.model->yachtBones.cam]) * glm::vec4(0, 0, 0, 1);
+            prepBuffer.camYaw = -atan2(model.u_model[0][1], model.u_model[1][1]);
+        }
+    }
+
+    // Camera as executeRender will set it up from this buffer, the live camera belongs to the main thread
+    prepBuffer.view = Camera::latestView();
+    glm::vec3 viewPosition = prepBuffer.view.position(prepBuffer.camPos);
+
+    cullScene(scene, prepBuffer, viewPosition);
+
+    int modelCount = static_cast<int>(scene.structModels.size());
+    int opaqueStart = modelCount;
+    int transparentStart = opaqueStart + static_cast<int>(scene.opaqueUnitPlanes.size());
+    int gridStart = transparentStart + static_cast<int>(scene.transparentUnitPlanes.size());
+    int itemCount = gridStart + static_cast<int>(scene.grids.size());
+
+    auto hasHitbox = [&](const ModelData &model)
+    { return showHitboxes && model.model->hitboxMeshes.has_value() && !model.model->hitboxMeshes->empty(); };
+
+    // Command slot of every item in every pass, a model's hitbox goes right after it in the main pass
+    int slotCounts[renderPassCount] = {};
+    for (auto &slots : passSlots)
+        slots.assign(itemCount, -1);
+    visibleItems.clear();
+
+    for (int item = 0; item < itemCount; item++)
+    {
+        bool visible = false;
+        for (int pass = 0; pass < renderPassCount; pass++)
+        {
+            // The water passes never draw transparent planes
+            bool transparent = item >= transparentStart && item < gridStart;
+            if (!passVisible[pass][item] || (pass != static_cast<int>(RenderPass::Main) && transparent))
+                continue;
+
+            passSlots[pass][item] = slotCounts[pass]++;
+            if (pass == static_cast<int>(RenderPass::Main) && item < modelCount && hasHitbox(scene.structModels[item]))
+                slotCounts[pass]++;
+            visible = true;
+        }
+
+        if (visible)
+            visibleItems.push_back(item);
+    }
+
+    int mainVisible = static_cast<int>(std::count(passVisible[0].begin(), passVisible[0].end(), 1));
+    visibleObjects.store(mainVisible, std::memory_order_relaxed);
+    culledObjects.store(itemCount - mainVisible, std::memory_order_relaxed);
+
+    for (int pass = 0; pass < renderPassCount; pass++)
+    {
+        prepBuffer.commandBuffers[pass].clear();
+        prepBuffer.commandBuffers[pass].resize(slotCounts[pass]);
+    }
+
+    // Skinning matrices of all animated models in one block, every pass uses the same copy
+    int boneCount = 0;
+    for (int item : visibleItems)
+        if (item < modelCount && scene.structModels[item].animated)
+            boneCount += static_cast<int>(scene.structModels[item].model->boneInverseOffsets.size());
+
+    prepBuffer.boneBlock = prepBuffer.arena.allocate<glm::mat4>(boneCount);
+    prepBuffer.boneBlockCount = boneCount;
+
+    // Reserve the per frame data of every visible model up front, the jobs below only fill it in
+    modelTextureLayers.resize(modelCount);
+    modelBoneTransforms.resize(modelCount);
+    uint32_t boneOffset = prepBuffer.boneBlock;
+
+    for (int item : visibleItems)
+    {
+        if (item >= modelCount)
+            break;
+
+        ModelData &model = scene.structModels[item];
+        modelTextureLayers[item] = prepBuffer.arena.allocate<int>(model.model->texturePaths.size());
+
+        if (model.animated)
+        {
+            modelBoneTransforms[item] = boneOffset;
+            boneOffset += static_cast<uint32_t>(model.model->boneInverseOffsets.size() * sizeof(glm::mat4));
+        }
+    }
+
+    // Every visible item once, spread over the job system, its command is copied into each pass that sees it
+    ThreadManager::jobSystem->parallelFor(static_cast<int>(visibleItems.size()), 16, [&](int index)
+                                          {
+        AllocationCounter::Scope countAllocations;
+
+        int item = visibleItems[index];
+        RenderCommand cmd{};
+
+        // Load Models
+        if (item < modelCount)
+        {
+            ModelData &model = scene.structModels[item];
+
             cmd.type = RenderType::Model;
 
-            cmd.shader = model.shader; 
+            cmd.shader = model.shader;
             cmd.color = model.color;
-            
+
             cmd.modelMatrix = model.u_model;
             cmd.normalMatrix = model.u_normal;
 
-            TextureManager::getTextureData(*model.model, cmd.textureUnit, cmd.textureArrayID, cmd.textureLayers);
+            cmd.textureLayerCount = static_cast<int>(model.model->texturePaths.size());
+            cmd.textureLayers = modelTextureLayers[item];
+            TextureManager::getTextureData(*model.model, cmd.textureUnit, cmd.textureArrayID, prepBuffer.arena.get<int>(cmd.textureLayers));
 
             cmd.animated = model.animated;
 
             if (cmd.animated)
             {
-                cmd.boneTransforms = model.model->getReadBuffer();
-                cmd.boneInverseOffsets = model.model->boneInverseOffsets;
-            }
+                cmd.boneCount = static_cast<int>(model.model->boneInverseOffsets.size());
+                cmd.boneTransforms = modelBoneTransforms[item];
 
-            float distanceFromCamera = glm::distance(glm::vec3(model.u_model[3]), Camera::getPosition());
+                // Final skinning matrices, the inverse offsets are folded in once here instead of per vertex and pass
+                const std::vector<glm::mat4> &bones = model.bonePalette->read();
+                MatrixBatch::product(bones.data(), model.model->boneInverseOffsets.data(), std::min<size_t>(bones.size(), cmd.boneCount), prepBuffer.arena.get<glm::mat4>(cmd.boneTransforms));
+            }
 
-            cmd.lod = 0;
-            if (distanceFromCamera > SettingsManager::settings.video.lodDistance) cmd.lod = 1;
-            if (SceneManager::engineState == EngineState::Title) cmd.lod = 0;
+            // Coarser meshes in the water passes, they are only seen distorted
+            int lodCount = static_cast<int>(model.model->lodMeshes.size());
+            for (int pass = 0; pass < renderPassCount; pass++)
+            {
+                int slot = passSlots[pass][item];
+                if (slot < 0)
+                    continue;
 
-            if (cmd.lod >= model.model->lodMeshes.size())
-                cmd.lod = static_cast<int>(std::round(model.model->lodMeshes.size())) - 1;
+                cmd.lod = modelLods[item];
+                if (pass != static_cast<int>(RenderPass::Main))
+                    cmd.lod = std::min(cmd.lod + waterLodBias, lodCount - 1);
 
-            cmd.meshes = std::shared_ptr<std::vector<MeshVariant>>(&model.model->lodMeshes[cmd.lod], [](std::vector<MeshVariant>*) {});
+                cmd.meshes = model.model->lodMeshes[cmd.lod].data();
+                cmd.meshCount = static_cast<int>(model.model->lodMeshes[cmd.lod].size());
 
-            return cmd; }));
+                prepBuffer.commandBuffers[pass][slot] = cmd;
+            }
 
-        // Hitboxes
-        if (SettingsManager::settings.debug.showHitboxes)
-        {
-            if (model.model->hitboxMeshes.has_value() && !model.model->hitboxMeshes->empty())
+            // Hitboxes
+            int mainSlot = passSlots[static_cast<int>(RenderPass::Main)][item];
+            if (mainSlot >= 0 && hasHitbox(model))
             {
-                futures.push_back(std::async(std::launch::async, [&model]()
-                                             {
-                    RenderCommand cmd;
-                    
-                    cmd.type = RenderType::Hitbox;
+                RenderCommand &hitbox = prepBuffer.commandBuffers[static_cast<int>(RenderPass::Main)][mainSlot + 1];
 
-                    cmd.shader = shaderID::Hitbox; 
-                    cmd.color = glm::vec3(1,0,0);
-                    
-                    cmd.modelMatrix = model.u_model;
+                hitbox.type = RenderType::Hitbox;
 
-                    cmd.animated = model.animated;
+                hitbox.shader = shaderID::Hitbox;
+                hitbox.color = glm::vec3(1, 0, 0);
 
-                    if (cmd.animated)
-                    {
-                        cmd.boneTransforms = model.model->getReadBuffer();
-                        cmd.boneInverseOffsets = model.model->boneInverseOffsets;
-                    }
+                hitbox.modelMatrix = model.u_model;
 
-                    cmd.meshes = std::shared_ptr<std::vector<MeshVariant>>(&model.model->hitboxMeshes.value(), [](std::vector<MeshVariant>*) {});
+                hitbox.animated = model.animated;
 
-                    return cmd; }));
+                hitbox.meshes = model.model->hitboxMeshes->data();
+                hitbox.meshCount = static_cast<int>(model.model->hitboxMeshes->size());
             }
+            return;
         }
 
-        if (model.controlled)
+        // Load opaque UnitPlanes
+        if (item < transparentStart)
         {
-            prepBuffer.camPos = (model.u_model * model.model->getReadBuffer()[model.model->boneHierarchy["Armature_Cam"]->index]) * glm::vec4(0, 0, 0, 1);
-            prepBuffer.camYaw = -atan2(model.u_model[0][1], model.u_model[1][1]);
-        }
-    }
+            UnitPlaneData &opaquePlane = scene.opaqueUnitPlanes[item - opaqueStart];
 
-    // Load opaque UnitPlanes
-    for (auto &opaquePlane : SceneManager::currentScene->opaqueUnitPlanes)
-    {
-        futures.push_back(std::async(std::launch::async, [opaquePlane]()
-                                     {
-            RenderCommand cmd;
-            
             cmd.type = RenderType::OpaquePlane;
 
             cmd.shader = opaquePlane.shader;
@@ -823,27 +1353,15 @@ void Render::prepareRender(::RenderBuffer &prepBuffer)
             cmd.modelMatrix = opaquePlane.u_model;
             cmd.normalMatrix = opaquePlane.u_normal;
 
-            auto meshList = std::make_shared<std::vector<MeshVariant>>(std::initializer_list<MeshVariant>{opaquePlane.unitPlane});
-            cmd.meshes = meshList;
-
-            return cmd; }));
-    }
+            cmd.meshes = &opaquePlane.unitPlane;
+            cmd.meshCount = 1;
+        }
 
-    // Sort transparent planes back to front based on distance from the camera
-    std::sort(SceneManager::currentScene->transparentUnitPlanes.begin(), SceneManager::currentScene->transparentUnitPlanes.end(), [&](const UnitPlaneData &a, const UnitPlaneData &b)
-              {
-                  float distA = glm::distance(Camera::getPosition(), a.position);
-                  float distB = glm::distance(Camera::getPosition(), b.position);
-                  return distA > distB; // Sort by distance: farthest first, closest last
-              });
+        // Load transparent UnitPlanes
+        else if (item < gridStart)
+        {
+            UnitPlaneData &transparentPlane = scene.transparentUnitPlanes[item - transparentStart];
 
-    // Load transparent UnitPlanes
-    for (auto &transparentPlane : SceneManager::currentScene->transparentUnitPlanes)
-    {
-        futures.push_back(std::async(std::launch::async, [transparentPlane]()
-                                     {
-            RenderCommand cmd;
-            
             cmd.type = RenderType::TransparentPlane;
 
             cmd.shader = transparentPlane.shader;
@@ -851,19 +1369,15 @@ void Render::prepareRender(::RenderBuffer &prepBuffer)
             cmd.modelMatrix = transparentPlane.u_model;
             cmd.normalMatrix = transparentPlane.u_normal;
 
-            auto meshList = std::make_shared<std::vector<MeshVariant>>(std::initializer_list<MeshVariant>{transparentPlane.unitPlane});
-            cmd.meshes = meshList;
+            cmd.meshes = &transparentPlane.unitPlane;
+            cmd.meshCount = 1;
+        }
 
-            return cmd; }));
-    }
+        // Load grids
+        else
+        {
+            GridData &grid = scene.grids[item - gridStart];
 
-    // Load grids
-    for (auto &grid : SceneManager::currentScene->grids)
-    {
-        futures.push_back(std::async(std::launch::async, [grid]()
-                                     {
-            RenderCommand cmd;
-            
             cmd.type = RenderType::Grid;
 
             cmd.shader = grid.shader;
@@ -873,16 +1387,23 @@ void Render::prepareRender(::RenderBuffer &prepBuffer)
 
             cmd.lod = grid.lod;
 
-            auto meshList = std::make_shared<std::vector<MeshVariant>>(std::initializer_list<MeshVariant>{grid.grid});
-            cmd.meshes = meshList;
+            cmd.meshes = &grid.grid;
+            cmd.meshCount = 1;
+        }
 
-            return cmd; }));
-    }
+        for (int pass = 0; pass < renderPassCount; pass++)
+            if (passSlots[pass][item] >= 0)
+                prepBuffer.commandBuffers[pass][passSlots[pass][item]] = cmd; });
 
-    for (auto &f : futures)
-    {
-        prepBuffer.commandBuffer.push_back(f.get());
-    }
+    for (auto &commands : prepBuffer.commandBuffers)
+        sortCommands(commands, viewPosition);
+
+    long long allocations = AllocationCounter::counted() - allocationsBefore;
+    prepAllocations.store(allocations, std::memory_order_relaxed);
+
+#ifdef MARAMA_CHECK_PREP_ALLOCATIONS
+    checkPrepAllocations(prepBuffer, scene, itemCount, slotCounts, allocations);
+#endif
 }
 
 void Render::executeRender(::RenderBuffer &renderBuffer, bool toScreen)
@@ -890,7 +1411,27 @@ void Render::executeRender(::RenderBuffer &renderBuffer, bool toScreen)
     // Set camera from buffer
     Camera::cameraPosition = renderBuffer.camPos;
     Camera::yaw = renderBuffer.camYaw;
-    Camera::update();
+    Camera::update(renderBuffer.view.position(renderBuffer.camPos), renderBuffer.view.rotation(renderBuffer.camYaw), renderBuffer.view.projection);
+
+    // Counted from here until the debug overlay, location lookups over the whole previous frame
+    int uniformLookups = ShaderUtil::uniformLocationQueries;
+    ShaderUtil::uniformLocationQueries = 0;
+    stats = RenderStats();
+    stats.uniformLookups = uniformLookups;
+    stats.streamWaits = StreamBuffer::waits;
+    stats.streamGrows = StreamBuffer::grows;
+    StreamBuffer::waits = StreamBuffer::grows = 0;
+    stats.textDraws = textDrawCount;
+    stats.textGlyphs = textGlyphCount;
+    textDrawCount = textGlyphCount = 0;
+    ShaderUtil::programBinds = 0;
+    MeshUtil::vertexArrayBinds = 0;
+
+    // Instances are shared by the water passes and the main pass
+    buildInstanceBatches(renderBuffer);
+
+    // Main view for the skybox, the water passes replace it with their own
+    updateFrameUniforms();
 
     // Bind to render buffer
     glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
@@ -909,23 +1450,32 @@ void Render::executeRender(::RenderBuffer &renderBuffer, bool toScreen)
     {
         waterTimer = remainder(waterTimer, 1 / SettingsManager::settings.video.waterFrameRate);
         WaterPass = true;
-        renderReflectRefract(renderBuffer.commandBuffer);
+        renderReflectRefract(renderBuffer);
         WaterPass = false;
-    }
 
-    // Reset clip plane
-    clipPlane = {0, 0, 0, 0};
+        // Reset clip plane, refraction left the main view matrix
+        clipPlane = {0, 0, 0, 0};
+        updateFrameUniforms();
+    }
 
     // Render rest of scene
-    renderObjects(renderBuffer.commandBuffer);
+    renderObjects(renderBuffer, RenderPass::Main);
 
     // Render debug menu
     if (SceneManager::engineState == EngineState::Running)
     {
+        // Physics only writes telemetry while its overlay is shown
+        bool physicsOverlay = SettingsManager::settings.debug.debugOverlay == debugOverlay::Physics;
+        Telemetry::physics.enabled.store(physicsOverlay, std::memory_order_relaxed);
+
         // Set debug data
         std::string debugText;
         FPS = (0.9f * FPS + 0.1f / TimeManager::deltaTime);
 
+        // Scene is drawn, the overlay itself is not counted
+        stats.programBinds = ShaderUtil::programBinds;
+        stats.vertexArrayBinds = MeshUtil::vertexArrayBinds;
+
         // Select which debug renderer to use
         switch (SettingsManager::settings.debug.debugOverlay)
         {
@@ -933,15 +1483,32 @@ void Render::executeRender(::RenderBuffer &renderBuffer, bool toScreen)
             break;
 
         case debugOverlay::FPS:
-            renderText(std::to_string(static_cast<int>(FPS)), 0.01f, 0.01f, 0.33f, debugColor);
+            debugText = std::to_string(static_cast<int>(FPS)) + "\n";
+            debugText += "prep allocs: " + std::to_string(prepAllocations.load(std::memory_order_relaxed)) + "\n";
+            debugText += "visible: " + std::to_string(visibleObjects.load(std::memory_order_relaxed)) + " culled: " + std::to_string(culledObjects.load(std::memory_order_relaxed)) + "\n";
+            debugText += "posed: " + std::to_string(Animation::posedModels.load(std::memory_order_relaxed)) + " at rest: " + std::to_string(Animation::skippedModels.load(std::memory_order_relaxed)) + "\n";
+            debugText += "commands main/reflect/refract: " + std::to_string(renderBuffer.commandBuffers[0].size()) + "/" + std::to_string(renderBuffer.commandBuffers[1].size()) + "/" + std::to_string(renderBuffer.commandBuffers[2].size()) + "\n";
+            debugText += "draw calls: " + std::to_string(stats.drawCalls) + "\n";
+            debugText += "program binds: " + std::to_string(stats.programBinds) + "\n";
+            debugText += "vertex array binds: " + std::to_string(stats.vertexArrayBinds) + "\n";
+            debugText += "texture binds: " + std::to_string(stats.textureBinds) + "\n";
+            debugText += "state toggles: " + std::to_string(stats.stateToggles) + "\n";
+            debugText += "uniform lookups: " + std::to_string(stats.uniformLookups) + "\n";
+            debugText += "frame uniform updates: " + std::to_string(stats.frameUniformUpdates) + "\n";
+            debugText += "text: " + std::to_string(stats.textGlyphs) + " glyphs in " + std::to_string(stats.textDraws) + " draws\n";
+            debugText += std::string(frameStream.persistent() ? "persistent" : "orphaned") + " streams, waits: " + std::to_string(stats.streamWaits) + " grows: " + std::to_string(stats.streamGrows) + "\n";
+
+            renderText(debugText, 0.01f, 0.01f, 0.33f, debugColor);
             break;
 
         case debugOverlay::Physics:
             debugText = "Physics:\n";
 
-            for (auto entry : debugPhysicsData)
+            Telemetry::physics.readLatest(physicsTelemetry);
+            for (int i = 0; i < physicsTelemetry.count; i++)
             {
-                debugText = debugText + entry.first + ": " + std::to_string(entry.second) + "\n";
+                const Telemetry::Record &record = physicsTelemetry.records[i];
+                debugText = debugText + Telemetry::name(record.key) + ": " + std::to_string(record.value) + "\n";
             }
 
             renderText(debugText, 0.01f, 0.01f, 0.33f, debugColor);
@@ -951,6 +1518,7 @@ void Render::executeRender(::RenderBuffer &renderBuffer, bool toScreen)
 
     renderSceneTexts();
     renderSceneImages();
+    flushText();
 
     savePauseBackground();
 
@@ -961,8 +1529,8 @@ void Render::executeRender(::RenderBuffer &renderBuffer, bool toScreen)
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         shader = ShaderUtil::load(shaderID::Post);
-        shader->setInt("screenTexture", 0);
-        shader->setBool("flipY", false);
+        shader->setInt(Uniforms::screenTexture, 0);
+        shader->setBool(Uniforms::flipY, false);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, sceneTexture);
 
@@ -980,88 +1548,59 @@ void Render::renderText(std::string text, float x, float y, float scale, glm::ve
     y *= WindowManager::screenUIScale * 1440.0f;
     scale *= WindowManager::screenUIScale;
 
-    float originalX = x;
-
-    if (textAlign != TextAlign::Left)
-    {
-        float textWidth = calculateTextWidth(text, scale);
-        if (textAlign == TextAlign::Center)
-            x -= textWidth / 2.0f;
-        else if (textAlign == TextAlign::Right)
-            x -= textWidth;
-    }
-
-    // Load the shader for rendering text
-    shader = ShaderUtil::load(shaderID::Text);
-
-    if (shader != lastShader || WindowManager::windowSizeChanged)
-    {
-        // Set the projection matrix for the text shader
-        glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(WindowManager::screenWidth), static_cast<float>(WindowManager::screenHeight), 0.0f);
-        shader->setMat4("projection", projection);
-
-        lastShader = shader;
-    }
-
-    // Set text color uniform
-    shader->setVec3("textColor", color.r, color.g, color.b);
-    shader->setFloat("textAlpha", alpha);
+    glm::vec4 tint(color, alpha);
+    size_t first = textVertices.size();
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, textTexture);
-
-    glBindVertexArray(textVAO);
-
-    // Enable blending for text rendering
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    float startX = x;                                          // Store the initial x position
-    float lineSpacing = Characters['H'].Size.y * scale * 1.5f; // Adjust line spacing with a small padding
+    float startX = x;                               // Store the initial x position
+    float lineSpacing = glyphHeight * scale * 1.5f; // Adjust line spacing with a small padding
+    float textWidth = 0.0f;
 
     for (char c : text)
     {
         if (c == '\n')
         {
+            textWidth = std::max(textWidth, x - startX);
             x = startX;       // Reset x to the start of the line
             y += lineSpacing; // Move y down by the height of a character plus padding
             continue;
         }
 
-        Character ch = Characters[c];
-
-        // Calculate the position of each character
-        float xpos = x + ch.Bearing.x * scale;
-        float ypos = y + (Characters['H'].Size.y - ch.Bearing.y) * scale; // Adjust y-coordinate calculation
-        float w = ch.Size.x * scale;
-        float h = ch.Size.y * scale;
-
-        // Prepare the vertices and texture coordinates with counter-clockwise winding
-        float vertices[6][4] = {
-            {xpos, ypos + h, ch.TexCoords.x, ch.TexCoords.y + ch.TexCoords.w}, // Bottom-left
-            {xpos + w, ypos, ch.TexCoords.x + ch.TexCoords.z, ch.TexCoords.y}, // Top-right
-            {xpos, ypos, ch.TexCoords.x, ch.TexCoords.y},                      // Top-left
-
-            {xpos, ypos + h, ch.TexCoords.x, ch.TexCoords.y + ch.TexCoords.w},                      // Bottom-left
-            {xpos + w, ypos + h, ch.TexCoords.x + ch.TexCoords.z, ch.TexCoords.y + ch.TexCoords.w}, // Bottom-right
-            {xpos + w, ypos, ch.TexCoords.x + ch.TexCoords.z, ch.TexCoords.y}                       // Top-right
-        };
-
-        // Update VBO with new vertex data
-        glBindBuffer(GL_ARRAY_BUFFER, textVBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
+        unsigned char code = static_cast<unsigned char>(c);
+        if (code >= glyphs.size())
+            continue;
+        const Character &ch = glyphs[code];
 
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        // Whitespace only moves the pen
+        if (ch.Size.x > 0 && ch.Size.y > 0)
+        {
+            // Calculate the position of each character
+            float xpos = x + ch.Bearing.x * scale;
+            float ypos = y + (glyphHeight - ch.Bearing.y) * scale; // Adjust y-coordinate calculation
+            float w = ch.Size.x * scale;
+            float h = ch.Size.y * scale;
+
+            // Prepare the vertices and texture coordinates with counter-clockwise winding
+            textVertices.push_back({{xpos, ypos + h, ch.TexCoords.x, ch.TexCoords.y + ch.TexCoords.w}, tint}); // Bottom-left
+            textVertices.push_back({{xpos + w, ypos, ch.TexCoords.x + ch.TexCoords.z, ch.TexCoords.y}, tint}); // Top-right
+            textVertices.push_back({{xpos, ypos, ch.TexCoords.x, ch.TexCoords.y}, tint});                      // Top-left
+
+            textVertices.push_back({{xpos, ypos + h, ch.TexCoords.x, ch.TexCoords.y + ch.TexCoords.w}, tint});                      // Bottom-left
+            textVertices.push_back({{xpos + w, ypos + h, ch.TexCoords.x + ch.TexCoords.z, ch.TexCoords.y + ch.TexCoords.w}, tint}); // Bottom-right
+            textVertices.push_back({{xpos + w, ypos, ch.TexCoords.x + ch.TexCoords.z, ch.TexCoords.y}, tint});                      // Top-right
+        }
 
         x += (ch.Advance >> 6) * scale;
     }
 
-    // Unbind the texture
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    // Aligned text is shifted by its widest line once it is laid out
+    if (textAlign != TextAlign::Left)
+    {
+        textWidth = std::max(textWidth, x - startX);
+        float shift = textAlign == TextAlign::Center ? textWidth / 2.0f : textWidth;
 
-    // Disable blending after text rendering
-    glDisable(GL_BLEND);
+        for (size_t i = first; i < textVertices.size(); i++)
+            textVertices[i].vertex.x -= shift;
+    }
 }
 
 void Render::renderBlankScreen()
@@ -1122,6 +1661,7 @@ void Render::renderLoadingScreen()
 
     renderText(statusString, 0.05f, 0.05f, 1.0f, glm::vec3(1.0f, 1.0f, 1.0f));
     renderText(progressString, 0.05f, 0.20f, 0.5f, glm::vec3(0.6f, 0.1f, 0.1f));
+    flushText();
 
     glBindVertexArray(quadVAO);
     glDrawArrays(GL_TRIANGLES, 0, 6);
@@ -1194,10 +1734,10 @@ void Render::renderMenu(EngineState state)
         glBindTexture(GL_TEXTURE_2D, pauseTexture);
 
         shader = ShaderUtil::load(shaderID::DarkenBlur);
-        shader->setInt("screenTexture", 0);
-        shader->setVec2("texelSize", glm::vec2(1.0 / WindowManager::screenWidth, 1.0 / WindowManager::screenHeight));
-        shader->setFloat("darkenAmount", darken);
-        shader->setFloat("darkenPosition", 0.3f + darkenOffset);
+        shader->setInt(Uniforms::screenTexture, 0);
+        shader->setVec2(Uniforms::texelSize, glm::vec2(1.0 / WindowManager::screenWidth, 1.0 / WindowManager::screenHeight));
+        shader->setFloat(Uniforms::darkenAmount, darken);
+        shader->setFloat(Uniforms::darkenPosition, 0.3f + darkenOffset);
 
         glBindVertexArray(quadVAO);
         glDrawArrays(GL_TRIANGLES, 0, 6);
@@ -1246,5 +1786,7 @@ void Render::renderMenu(EngineState state)
         renderText("Will reload to apply changes", 0.98f, titleY, 1.0f, glm::vec3(1.0f, 0.0f, 0.0f), alpha, TextAlign::Right);
     }
 
+    flushText();
+
     glEnable(GL_DEPTH_TEST);
 }
\ No newline at end of file
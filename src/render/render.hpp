@@ -28,7 +28,11 @@ namespace Render
 
     inline unsigned int sceneFBO = 0;
 
-    inline std::vector<std::pair<std::string, float>> debugPhysicsData;
+    // Heap allocations of the last render prep on any thread, zero once every buffer has warmed up
+    inline std::atomic<long long> prepAllocations = 0;
+
+    // Scene items the last render prep kept and dropped by frustum culling
+    inline std::atomic<int> visibleObjects = 0, culledObjects = 0;
 
     void renderBlankScreen();
     void renderLoadingScreen();
@@ -42,5 +46,8 @@ namespace Render
     void prepareRender(::RenderBuffer &prepBuffer);
     void executeRender(::RenderBuffer &renderBuffer, bool toScreen = true);
 
+    // Before every swap, fences what this frame streamed to the GPU
+    void endFrame();
+
     void renderText(std::string text, float x, float y, float scale, glm::vec3 color, float alpha = 1.0f, TextAlign textAlign = TextAlign::Left);
 };
\ No newline at end of file
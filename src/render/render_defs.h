@@ -29,6 +29,51 @@ enum class RenderType
     Grid
 };
 
+// Views a frame is drawn from, each has its own command list
+enum class RenderPass
+{
+    Main,
+    Reflection,
+    Refraction
+};
+inline constexpr int renderPassCount = 3;
+
+// Per view uniform block, std140 layout of FrameData in the shaders
+struct FrameUniforms
+{
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 camXY;
+    glm::vec4 clipPlane;
+    glm::vec3 viewPos;
+    float lightIntensity;
+    glm::vec3 lightPos;
+    float pad0;
+    glm::vec3 lightCol;
+    float pad1;
+};
+static_assert(sizeof(FrameUniforms) == 256, "FrameUniforms must match the std140 FrameData block");
+
+// What the executor sent to GL in one frame, shown in the FPS overlay
+struct RenderStats
+{
+    int drawCalls = 0;
+    int programBinds = 0;
+    int vertexArrayBinds = 0;
+    int textureBinds = 0;
+    int stateToggles = 0;
+    int uniformLookups = 0;
+    int frameUniformUpdates = 0;
+
+    // Text of the whole previous frame, menus included
+    int textDraws = 0;
+    int textGlyphs = 0;
+
+    // Stream buffer stalls on the GPU and ring growth since the previous frame
+    int streamWaits = 0;
+    int streamGrows = 0;
+};
+
 enum class TextAlign
 {
     Left,
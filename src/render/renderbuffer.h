@@ -1,21 +1,28 @@
 #pragma once
 
-#include <memory>
+#include <array>
+#include <cstdint>
+#include <type_traits>
 
+#include "camera/camera.hpp"
 #include "mesh/meshvariant.h"
+#include "render/frame_arena.h"
 #include "render/render_defs.h"
 
+// Plain record of one draw, meshes and bind pose live in the model or scene, per frame data in the buffer's arena
 struct RenderCommand
 {
     RenderType type;
 
     shaderID shader;
     glm::vec3 color;
-    std::shared_ptr<std::vector<MeshVariant>> meshes;
+    MeshVariant *meshes = nullptr;
+    int meshCount = 0;
 
     unsigned int textureUnit;
     unsigned int textureArrayID;
-    std::vector<int> textureLayers;
+    uint32_t textureLayers = 0;
+    int textureLayerCount = 0;
 
     glm::mat4 modelMatrix;
     glm::mat4 normalMatrix;
@@ -23,14 +30,23 @@ struct RenderCommand
     int lod;
 
     bool animated = false;
-    std::vector<glm::mat4> boneTransforms;
-    std::vector<glm::mat4> boneInverseOffsets;
+    uint32_t boneTransforms = 0;
+    int boneCount = 0;
 };
+static_assert(std::is_trivially_copyable_v<RenderCommand>, "Render commands are copied around as plain data");
 
 struct RenderBuffer
 {
-    std::vector<RenderCommand> commandBuffer;
+    // Sorted commands of every pass, the water passes only hold what their views see
+    std::array<std::vector<RenderCommand>, renderPassCount> commandBuffers;
+    FrameArena arena;
+
+    // Skinning matrices of every animated model in one arena block, shared by all passes
+    uint32_t boneBlock = 0;
+    int boneBlockCount = 0;
+
     std::atomic<BufferState> state = BufferState::Free;
     float camYaw;
     glm::vec3 camPos;
-};
\ No newline at end of file
+    Camera::View view;
+};
@@ -0,0 +1,148 @@
+#include "render/stream_buffer.hpp"
+
+#include <cstring>
+
+// Buffer storage is GL 4.4 or ARB_buffer_storage, newer than the loader, so it is looked up by hand
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+typedef void(APIENTRYP BufferStorageProc)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+
+BufferStorageProc bufferStorage()
+{
+    static BufferStorageProc proc = glfwExtensionSupported("GL_ARB_buffer_storage") ? reinterpret_cast<BufferStorageProc>(glfwGetProcAddress("glBufferStorage")) : nullptr;
+    return proc;
+}
+
+void waitFence(GLsync &fence)
+{
+    if (!fence)
+        return;
+
+    // Only count it when the GPU is actually behind
+    if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+    {
+        StreamBuffer::waits++;
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED)
+            ;
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void StreamBuffer::init(size_t size)
+{
+    // Regions start on a multiple of the largest uniform buffer alignment in use
+    allocate((size + 255) / 256 * 256);
+}
+
+void StreamBuffer::allocate(size_t newFrameSize)
+{
+    frameSize = newFrameSize;
+
+    // The copy target leaves the array, uniform and texture bindings alone
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+
+    mapped = nullptr;
+    if (BufferStorageProc storage = bufferStorage())
+    {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        storage(GL_COPY_WRITE_BUFFER, frameSize * framesInFlight, nullptr, flags);
+        mapped = static_cast<unsigned char *>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, frameSize * framesInFlight, flags));
+
+        // Immutable storage can not be orphaned, start over with a plain buffer
+        if (!mapped)
+        {
+            glDeleteBuffers(1, &buffer);
+            glGenBuffers(1, &buffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        }
+    }
+
+    regions = mapped ? framesInFlight : 1;
+    if (!mapped)
+        glBufferData(GL_COPY_WRITE_BUFFER, frameSize, nullptr, GL_STREAM_DRAW);
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    frame = 0;
+    head = 0;
+}
+
+StreamSlice StreamBuffer::upload(const void *data, size_t size, size_t alignment)
+{
+    size_t offset = (head + alignment - 1) / alignment * alignment;
+
+    // Out of room, move to a larger ring and keep the old buffer until the frame is over
+    if (offset + size > frameSize)
+    {
+        for (GLsync &fence : fences)
+            if (fence)
+            {
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+
+        if (mapped)
+        {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        }
+        retired.push_back(buffer);
+
+        size_t newFrameSize = frameSize * 2;
+        while (newFrameSize < size)
+            newFrameSize *= 2;
+        allocate(newFrameSize);
+
+        grows++;
+        offset = 0;
+    }
+
+    head = offset + size;
+    size_t position = frame * frameSize + offset;
+
+    if (mapped)
+        std::memcpy(mapped + position, data, size);
+    else
+    {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, position, size, data);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    return {buffer, position};
+}
+
+void StreamBuffer::endFrame()
+{
+    // Nothing from this frame points into them anymore, GL keeps them alive for draws still queued
+    if (!retired.empty())
+    {
+        glDeleteBuffers(static_cast<GLsizei>(retired.size()), retired.data());
+        retired.clear();
+    }
+
+    if (mapped)
+    {
+        fences[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        frame = (frame + 1) % regions;
+        waitFence(fences[frame]);
+    }
+    else
+    {
+        // Fresh storage from the driver, the GPU keeps reading the old one
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, frameSize, nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    head = 0;
+}
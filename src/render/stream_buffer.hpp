@@ -0,0 +1,52 @@
+#pragma once
+
+#ifndef __glad_h_
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#endif
+
+#include <cstddef>
+#include <vector>
+
+// Where an upload landed, the ring moves to a new buffer when it grows so the buffer is part of it
+struct StreamSlice
+{
+    unsigned int buffer = 0;
+    size_t offset = 0;
+};
+
+// Ring of per frame regions in one buffer, a frame writes its own region while the GPU still reads the older ones
+// Persistently mapped and fenced when the driver has buffer storage, otherwise a single region orphaned every frame
+class StreamBuffer
+{
+public:
+    // One region per render buffer
+    static constexpr int framesInFlight = 3;
+
+    void init(size_t frameSize);
+
+    // Copy into this frame's region, the slice stays valid until endFrame
+    StreamSlice upload(const void *data, size_t size, size_t alignment);
+
+    // Fence this frame's region and move on to the next, waits only if the GPU is still reading it
+    void endFrame();
+
+    bool persistent() const { return mapped != nullptr; }
+
+    // Times a frame had to wait for the GPU, and times a ring outgrew its regions
+    static inline int waits = 0, grows = 0;
+
+private:
+    void allocate(size_t newFrameSize);
+
+    unsigned int buffer = 0;
+    unsigned char *mapped = nullptr;
+    size_t frameSize = 0;
+    int regions = 1;
+    int frame = 0;
+    size_t head = 0;
+    GLsync fences[framesInFlight] = {};
+
+    // Buffers the ring grew out of, slices of this frame may still point into them
+    std::vector<unsigned int> retired;
+};
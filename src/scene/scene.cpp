@@ -176,6 +176,11 @@ void Scene::loadModelToScene(JSONModel model)
 
     // Model animation data
     loadModel.animated = model.animated;
+    if (loadModel.animated)
+    {
+        loadModel.bonePalette = std::make_unique<BonePalette>();
+        loadModel.bonePalette->resize(loadModel.model->boneHierarchy.size());
+    }
     loadModel.controlled = model.controlled;
     for (auto type : model.physics)
     {
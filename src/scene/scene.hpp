@@ -8,16 +8,20 @@
 #include <unordered_map>
 
 #include "scene/scene_defs.h"
+#include "physics/physics_world.hpp"
 
 class Scene
 {
 public:
     Scene(std::string jsonPath, std::string sceneName);
+    // Empty scene, for checks that fill it in by hand
+    Scene() = default;
     void uploadToGPU();
 
     // Local scene data
     std::string name;
     std::vector<ModelData> structModels;
+    PhysicsWorld physicsWorld;
     std::unordered_map<std::string, Model> loadedModels;
     std::vector<std::string> loadedYachts;
     std::vector<UnitPlaneData> transparentUnitPlanes;
@@ -2,14 +2,17 @@
 
 #include <glm/glm.hpp>
 
+#include <array>
+#include <memory>
 #include <string>
 #include <vector>
 #include <optional>
 
 #include "mesh/mesh_util.hpp"
 #include "mesh/meshvariant.h"
+#include "model/bone_palette.h"
 #include "model/model_defs.h"
-#include "physics/physicsbuffer.h"
+#include "physics/physics_defs.h"
 #include "shader/shaderID.h"
 
 class Model;
@@ -101,8 +104,15 @@ struct ModelData
     glm::vec3 color;
     bool animated;
     bool controlled;
-    std::optional<PhysicsBuffer> physics;
+    int physicsIndex = -1;
     std::vector<PhysicsType> physicsTypes;
+
+    // Own palette of every animated instance, models of the same type share the Model but not the pose
+    std::unique_ptr<BonePalette> bonePalette;
+
+    // Raw physics state the last published pose was built from, posed when that pose was a rest pose
+    std::array<float, 12> poseInputs{};
+    bool posed = false;
 };
 
 struct UnitPlaneData
@@ -37,6 +37,7 @@ void SceneManager::checkLoading()
         // Render final loading screen frame
         Render::renderLoadingScreen();
 
+        Render::endFrame();
         glfwSwapBuffers(WindowManager::window);
 
         // Now upload scene data to OpenGL
@@ -69,29 +70,19 @@ void SceneManager::runOneFrame()
         return;
 
     // Run one physics tick
-    for (ModelData &model : currentScene.get()->structModels)
-    {
-        if (model.physics.has_value())
-        {
-            model.physics->getWriteBuffer()->copyFrom(*model.physics->getReadBuffer());
-            model.physics->getWriteBuffer()->savePrevState();
-            model.physics->getWriteBuffer()->update(model);
-            model.physics->swapBuffers();
-        }
-    }
+    PhysicsWorld &world = currentScene->physicsWorld;
+    world.beginTicks();
+    PhysicsUtil::stepPhysics(world);
+    world.publish();
+    world.acquireReadState();
 
     // Update all bones once
     for (ModelData &model : currentScene.get()->structModels)
     {
         if (model.animated)
-        {
-            auto &writeBones = model.model->getWriteBuffer();
-            Animation::updateYachtBones(model, 1.0f, writeBones);
-        }
+            Animation::update(model, 1.0f);
     }
 
-    ModelUtil::swapBoneBuffers();
-
     // Render one frame to buffer
     Render::prepareRender(Render::renderBuffers[0]);
     Render::executeRender(Render::renderBuffers[0], false);
@@ -107,7 +98,10 @@ void SceneManager::unload()
     // Clear render buffers
     for (auto &buffer : Render::renderBuffers)
     {
-        buffer.commandBuffer.clear();
+        for (auto &commands : buffer.commandBuffers)
+            commands.clear();
+        buffer.boneBlockCount = 0;
+        buffer.arena.reset();
         buffer.state.store(BufferState::Free);
     }
 
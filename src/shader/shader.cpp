@@ -2,6 +2,8 @@
 
 #include "pch.h"
 
+#include <cstring>
+
 void Shader::init(const std::string &vertexCode, const std::string &fragmentCode)
 {
     m_vertexCode = vertexCode;
@@ -15,74 +17,85 @@ void Shader::use()
     glUseProgram(m_id);
 }
 
-void Shader::setBool(const std::string &name, bool value) const
+void Shader::setBool(Uniform uniform, bool value) const
+{
+    glUniform1i(location(uniform), (int)value);
+}
+
+void Shader::setInt(Uniform uniform, int value) const
+{
+    glUniform1i(location(uniform), value);
+}
+
+void Shader::setIntArray(Uniform uniform, const int *value, size_t count) const
 {
-    glUniform1i(glGetUniformLocation(m_id, name.c_str()), (int)value);
+    glUniform1iv(location(uniform), count, value);
 }
 
-void Shader::setInt(const std::string &name, int value) const
+void Shader::setFloat(Uniform uniform, float value) const
 {
-    glUniform1i(glGetUniformLocation(m_id, name.c_str()), value);
+    glUniform1f(location(uniform), value);
 }
 
-void Shader::setIntArray(const std::string &name, const int *value, size_t count) const
+void Shader::setVec2(Uniform uniform, const glm::vec2 &value) const
 {
-    glUniform1iv(glGetUniformLocation(m_id, name.c_str()), count, value);
+    glUniform2fv(location(uniform), 1, &value[0]);
 }
 
-void Shader::setFloat(const std::string &name, float value) const
+void Shader::setVec2(Uniform uniform, float x, float y) const
 {
-    glUniform1f(glGetUniformLocation(m_id, name.c_str()), value);
+    glUniform2f(location(uniform), x, y);
 }
 
-void Shader::setVec2(const std::string &name, const glm::vec2 &value) const
+void Shader::setVec3(Uniform uniform, const glm::vec3 &value) const
 {
-    glUniform2fv(glGetUniformLocation(m_id, name.c_str()), 1, &value[0]);
+    glUniform3fv(location(uniform), 1, &value[0]);
 }
 
-void Shader::setVec2(const std::string &name, float x, float y) const
+void Shader::setVec3(Uniform uniform, float x, float y, float z) const
 {
-    glUniform2f(glGetUniformLocation(m_id, name.c_str()), x, y);
+    glUniform3f(location(uniform), x, y, z);
 }
 
-void Shader::setVec3(const std::string &name, const glm::vec3 &value) const
+void Shader::setVec4(Uniform uniform, const glm::vec4 &value) const
 {
-    glUniform3fv(glGetUniformLocation(m_id, name.c_str()), 1, &value[0]);
+    glUniform4fv(location(uniform), 1, &value[0]);
 }
 
-void Shader::setVec3(const std::string &name, float x, float y, float z) const
+void Shader::setVec4(Uniform uniform, float x, float y, float z, float w) const
 {
-    glUniform3f(glGetUniformLocation(m_id, name.c_str()), x, y, z);
+    glUniform4f(location(uniform), x, y, z, w);
 }
 
-void Shader::setVec4(const std::string &name, const glm::vec4 &value) const
+void Shader::setMat2(Uniform uniform, const glm::mat2 &mat) const
 {
-    glUniform4fv(glGetUniformLocation(m_id, name.c_str()), 1, &value[0]);
+    glUniformMatrix2fv(location(uniform), 1, GL_FALSE, &mat[0][0]);
 }
 
-void Shader::setVec4(const std::string &name, float x, float y, float z, float w) const
+void Shader::setMat3(Uniform uniform, const glm::mat3 &mat) const
 {
-    glUniform4f(glGetUniformLocation(m_id, name.c_str()), x, y, z, w);
+    glUniformMatrix3fv(location(uniform), 1, GL_FALSE, &mat[0][0]);
 }
 
-void Shader::setMat2(const std::string &name, const glm::mat2 &mat) const
+void Shader::setMat4(Uniform uniform, const glm::mat4 &mat) const
 {
-    glUniformMatrix2fv(glGetUniformLocation(m_id, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix4fv(location(uniform), 1, GL_FALSE, &mat[0][0]);
 }
 
-void Shader::setMat3(const std::string &name, const glm::mat3 &mat) const
+void Shader::setMat4Array(Uniform uniform, const std::vector<glm::mat4> &mats) const
 {
-    glUniformMatrix3fv(glGetUniformLocation(m_id, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix4fv(location(uniform), mats.size(), GL_FALSE, glm::value_ptr(mats[0]));
 }
 
-void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const
+void Shader::setMat4Array(Uniform uniform, const glm::mat4 *mats, size_t count) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(m_id, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix4fv(location(uniform), count, GL_FALSE, glm::value_ptr(mats[0]));
 }
 
-void Shader::setMat4Array(const std::string &name, const std::vector<glm::mat4> &mats) const
+int Shader::location(Uniform uniform) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(m_id, name.c_str()), mats.size(), GL_FALSE, glm::value_ptr(mats[0]));
+    auto it = m_locations.find(uniform.hash);
+    return it != m_locations.end() ? it->second : -1;
 }
 
 void Shader::compile()
@@ -109,6 +122,42 @@ void Shader::link()
     checkLinkingError();
     glDeleteShader(m_vertexId);
     glDeleteShader(m_fragmentId);
+    cacheLocations();
+
+    // Per view data comes from one shared buffer
+    unsigned int frameBlock = glGetUniformBlockIndex(m_id, "FrameData");
+    if (frameBlock != GL_INVALID_INDEX)
+        glUniformBlockBinding(m_id, frameBlock, frameDataBinding);
+}
+
+void Shader::cacheLocations()
+{
+    m_locations.clear();
+
+    int uniformCount = 0;
+    glGetProgramiv(m_id, GL_ACTIVE_UNIFORMS, &uniformCount);
+
+    char name[256];
+    for (int i = 0; i < uniformCount; i++)
+    {
+        int length, size;
+        unsigned int type;
+        glGetActiveUniform(m_id, i, sizeof(name), &length, &size, &type, name);
+
+        int location = glGetUniformLocation(m_id, name);
+        ShaderUtil::uniformLocationQueries++;
+
+        // Uniform block members have no location
+        if (location < 0)
+            continue;
+
+        // Arrays are listed as name[0], the handle hashes the bare name
+        if (length > 3 && std::strcmp(name + length - 3, "[0]") == 0)
+            length -= 3;
+
+        if (!m_locations.emplace(Uniform::hashName(name, length), location).second)
+            std::cout << "Shader: Uniform hash collision on " << std::string(name, length) << std::endl;
+    }
 }
 
 void Shader::checkCompileError(unsigned int shader, const std::string type)
@@ -2,32 +2,43 @@
 
 #include <glm/glm.hpp>
 
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "shader/uniform.h"
+
 class Shader
 {
 public:
     void use();
     unsigned int m_id;
 
-    void setBool(const std::string &name, bool value) const;
-    void setInt(const std::string &name, int value) const;
-    void setIntArray(const std::string &name, const int *values, size_t count) const;
-    void setFloat(const std::string &name, float value) const;
-    void setVec2(const std::string &name, const glm::vec2 &value) const;
-    void setVec2(const std::string &name, float x, float y) const;
-    void setVec3(const std::string &name, const glm::vec3 &value) const;
-    void setVec3(const std::string &name, float x, float y, float z) const;
-    void setVec4(const std::string &name, const glm::vec4 &value) const;
-    void setVec4(const std::string &name, float x, float y, float z, float w) const;
-    void setMat2(const std::string &name, const glm::mat2 &mat) const;
-    void setMat3(const std::string &name, const glm::mat3 &mat) const;
-    void setMat4(const std::string &name, const glm::mat4 &mat) const;
-    void setMat4Array(const std::string &name, const std::vector<glm::mat4> &mats) const;
+    void setBool(Uniform uniform, bool value) const;
+    void setInt(Uniform uniform, int value) const;
+    void setIntArray(Uniform uniform, const int *values, size_t count) const;
+    void setFloat(Uniform uniform, float value) const;
+    void setVec2(Uniform uniform, const glm::vec2 &value) const;
+    void setVec2(Uniform uniform, float x, float y) const;
+    void setVec3(Uniform uniform, const glm::vec3 &value) const;
+    void setVec3(Uniform uniform, float x, float y, float z) const;
+    void setVec4(Uniform uniform, const glm::vec4 &value) const;
+    void setVec4(Uniform uniform, float x, float y, float z, float w) const;
+    void setMat2(Uniform uniform, const glm::mat2 &mat) const;
+    void setMat3(Uniform uniform, const glm::mat3 &mat) const;
+    void setMat4(Uniform uniform, const glm::mat4 &mat) const;
+    void setMat4Array(Uniform uniform, const std::vector<glm::mat4> &mats) const;
+    void setMat4Array(Uniform uniform, const glm::mat4 *mats, size_t count) const;
 
     void init(const std::string &vertexCode, const std::string &fragmentCode);
 
+    // Uniform buffer binding of the FrameData block in every program
+    static constexpr unsigned int frameDataBinding = 0;
+
+    // Location from the table built at link time, -1 if the program does not use it
+    int location(Uniform uniform) const;
+
 private:
     unsigned int m_vertexId;
     unsigned int m_fragmentId;
@@ -35,8 +46,11 @@ private:
     std::string m_vertexCode;
     std::string m_fragmentCode;
 
+    std::unordered_map<uint32_t, int> m_locations;
+
     void compile();
     void link();
+    void cacheLocations();
 
     void checkCompileError(unsigned int shader, const std::string type);
     void checkLinkingError();
@@ -21,6 +21,7 @@ Shader *ShaderUtil::load(const shaderID shaderID)
         lastShader = shaderID;
         shaderPtr = &loadedShaders[shaderID];
         shaderPtr->use();
+        programBinds++;
     }
     return shaderPtr;
 }
@@ -20,5 +20,7 @@ namespace ShaderUtil
     inline std::unordered_map<shaderID, Shader> loadedShaders;
 
     inline shaderID lastShader;
+    inline int programBinds = 0;
+    inline int uniformLocationQueries = 0;
     inline bool waterLoaded = false;
 };
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Uniform name hashed at compile time, shaders resolve it to a location once at link time
+struct Uniform
+{
+    uint32_t hash;
+    const char *name;
+
+    template <size_t N>
+    constexpr explicit Uniform(const char (&text)[N]) : hash(hashName(text, N - 1)), name(text) {}
+
+    // FNV-1a
+    static constexpr uint32_t hashName(const char *text, size_t length)
+    {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < length; i++)
+        {
+            hash ^= static_cast<uint8_t>(text[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+};
+
+// Every uniform the renderer sets, named as in the shaders
+namespace Uniforms
+{
+    // Text projection
+    inline constexpr Uniform projection{"projection"};
+
+    // Per object
+    inline constexpr Uniform u_model{"u_model"};
+    inline constexpr Uniform u_normal{"u_normal"};
+    inline constexpr Uniform u_bonePalette{"u_bonePalette"};
+    inline constexpr Uniform animated{"animated"};
+    inline constexpr Uniform bodyColor{"bodyColor"};
+    inline constexpr Uniform lod{"lod"};
+
+    // Textures
+    inline constexpr Uniform textureArray{"textureArray"};
+    inline constexpr Uniform textureLayers{"textureLayers"};
+    inline constexpr Uniform heightmap{"heightmap"};
+    inline constexpr Uniform sandTextureArray{"sandTextureArray"};
+    inline constexpr Uniform skybox{"skybox"};
+    inline constexpr Uniform screenTexture{"screenTexture"};
+    inline constexpr Uniform uTexture{"uTexture"};
+
+    // Water
+    inline constexpr Uniform toonWater{"toonWater"};
+    inline constexpr Uniform normalMap{"normalMap"};
+    inline constexpr Uniform waterTextureArray{"waterTextureArray"};
+    inline constexpr Uniform dudvMapLayer{"dudvMapLayer"};
+    inline constexpr Uniform normalMapLayer{"normalMapLayer"};
+    inline constexpr Uniform reflectionTexture{"reflectionTexture"};
+    inline constexpr Uniform refractionTexture{"refractionTexture"};
+    inline constexpr Uniform depthMap{"depthMap"};
+    inline constexpr Uniform moveOffset{"moveOffset"};
+
+    // GUI, text and post
+    inline constexpr Uniform uScreenSize{"uScreenSize"};
+    inline constexpr Uniform uPosition{"uPosition"};
+    inline constexpr Uniform uImageSize{"uImageSize"};
+    inline constexpr Uniform uScale{"uScale"};
+    inline constexpr Uniform uAlpha{"uAlpha"};
+    inline constexpr Uniform uRotation{"uRotation"};
+    inline constexpr Uniform uMirrored{"uMirrored"};
+    inline constexpr Uniform flipY{"flipY"};
+    inline constexpr Uniform texelSize{"texelSize"};
+    inline constexpr Uniform darkenAmount{"darkenAmount"};
+    inline constexpr Uniform darkenPosition{"darkenPosition"};
+};
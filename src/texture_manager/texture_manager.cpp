@@ -284,8 +284,10 @@ unsigned int TextureManager::loadSkyboxTexture(const SkyBoxData &skybox)
 
 void TextureManager::loadQueuedPixelData()
 {
-    std::vector<std::future<void>> tasks;
-    std::vector<std::shared_ptr<PendingTexture>> textures;
+    std::vector<PendingTexture> textures;
+
+    // Every texture to load, with the channel count to force, 0 keeps the file's own
+    std::vector<std::pair<PendingTexture *, int>> loads;
 
     // Standalones
     {
@@ -293,34 +295,14 @@ void TextureManager::loadQueuedPixelData()
 
         while (!textureQueue.empty())
         {
-            auto pt = std::make_shared<PendingTexture>(std::move(textureQueue.front()));
+            textures.push_back(std::move(textureQueue.front()));
             textureQueue.pop();
-
-            std::string path = pt->path;
-
-            tasks.push_back(std::async(std::launch::async, [pt, path]()
-                                       {
-                int width, height, channels;
-                unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
-
-                if (!data)
-                {
-                    std::cerr << "Failed to load pixel data: " << path << std::endl;
-                    return;
-                }
-
-                pt->width = width;
-                pt->height = height;
-                pt->channels = channels;
-                pt->pixelData.assign(data, data + (width * height * channels));
-                stbi_image_free(data); 
-                
-                SceneManager::loadingProgress.first++; }));
-
-            textures.push_back(pt);
         }
     }
 
+    for (PendingTexture &pt : textures)
+        loads.push_back({&pt, 0});
+
     // Texture Arrays
     {
         std::lock_guard<std::mutex> lock(textureArrayMutex);
@@ -328,33 +310,35 @@ void TextureManager::loadQueuedPixelData()
         for (auto &[arrayName, array] : textureArrays)
         {
             for (PendingTexture &pt : array.pendingTextures)
-            {
-                tasks.push_back(std::async(std::launch::async, [&pt]()
-                                           {
-                    int width, height, channels;
-                    unsigned char* data = stbi_load(pt.path.c_str(), &width, &height, &channels, 4);
-                    if (!data)
-                    {
-                        std::cerr << "Failed to load pixel data: " << pt.path << std::endl;
-                        return;
-                    }
-
-                    pt.width = width;
-                    pt.height = height;
-                    pt.channels = 4;
-                    pt.pixelData.assign(data, data + (width * height * 4));
-                    stbi_image_free(data); 
-                
-                    SceneManager::loadingProgress.first++; }));
-            }
+                loads.push_back({&pt, 4});
         }
     }
 
-    // Wait for all loading to finish
-    for (auto &task : tasks)
-    {
-        task.get();
-    }
+    // Decode on the job system, one texture per job
+    ThreadManager::jobSystem->parallelFor(static_cast<int>(loads.size()), 1, [&](int i)
+                                          {
+        PendingTexture &pt = *loads[i].first;
+        int forceChannels = loads[i].second;
+
+        int width, height, channels;
+        unsigned char* data = stbi_load(pt.path.c_str(), &width, &height, &channels, forceChannels);
+
+        if (!data)
+        {
+            std::cerr << "Failed to load pixel data: " << pt.path << std::endl;
+            return;
+        }
+
+        if (forceChannels)
+            channels = forceChannels;
+
+        pt.width = width;
+        pt.height = height;
+        pt.channels = channels;
+        pt.pixelData.assign(data, data + (width * height * channels));
+        stbi_image_free(data);
+
+        SceneManager::loadingProgress.first++; });
 
     // Now all textures are loaded, move them back to the queue safely
     {
@@ -362,7 +346,7 @@ void TextureManager::loadQueuedPixelData()
 
         for (auto &pt : textures)
         {
-            textureQueue.push(std::move(*pt));
+            textureQueue.push(std::move(pt));
         }
     }
 }
@@ -566,9 +550,10 @@ int TextureManager::getTextureLayerIndex(const std::string &arrayName, const std
     return -1;
 }
 
-void TextureManager::getTextureData(const Model &model, unsigned int &textureUnit, unsigned int &textureArrayID, std::vector<int> &textureLayers)
+void TextureManager::getTextureData(const Model &model, unsigned int &textureUnit, unsigned int &textureArrayID, int *textureLayers)
 {
-    textureLayers.clear();
+    // One layer per texture path of the model, -1 if it is not in the array
+    std::fill(textureLayers, textureLayers + model.texturePaths.size(), -1);
 
     auto itArray = textureArrays.find(model.textureArrayName);
     if (itArray == textureArrays.end())
@@ -583,16 +568,12 @@ void TextureManager::getTextureData(const Model &model, unsigned int &textureUni
     textureArrayID = texArray.textureArrayID;
 
     // For each texture path in the model, find its layer index in the texture array
-    for (const auto &texPath : model.texturePaths)
+    for (size_t i = 0; i < model.texturePaths.size(); i++)
     {
-        auto itLayer = texArray.textureLayerMap.find(texPath);
+        auto itLayer = texArray.textureLayerMap.find(model.texturePaths[i]);
         if (itLayer != texArray.textureLayerMap.end())
         {
-            textureLayers.push_back(itLayer->second);
-        }
-        else
-        {
-            textureLayers.push_back(-1);
+            textureLayers[i] = itLayer->second;
         }
     }
 }
\ No newline at end of file
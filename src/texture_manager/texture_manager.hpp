@@ -56,5 +56,5 @@ namespace TextureManager
     unsigned int getStandaloneTextureUnit(const std::string &texturePath);
     unsigned int getTextureArrayUnit(const std::string &arrayName);
     int getTextureLayerIndex(const std::string &arrayName, const std::string &texturePath);
-    void getTextureData(const Model &model, unsigned int &textureUnit, unsigned int &textureArrayID, std::vector<int> &textureLayers);
+    void getTextureData(const Model &model, unsigned int &textureUnit, unsigned int &textureArrayID, int *textureLayers);
 };
\ No newline at end of file
@@ -0,0 +1,244 @@
+#include "thread_manager/job_system.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    // Which system and queue the current thread works for
+    thread_local const JobSystem *workerSystem = nullptr;
+    thread_local int workerIndex = -1;
+}
+
+JobSystem::JobSystem(unsigned threadCount)
+{
+    // Waiting callers help out, so one thread less than asked is started
+    unsigned workerCount = threadCount > 1 ? threadCount - 1 : 0;
+
+    for (unsigned i = 0; i < workerCount; i++)
+        queues.push_back(std::make_unique<Queue>());
+
+    for (unsigned i = 0; i < workerCount; i++)
+        workers.emplace_back(&JobSystem::workerLoop, this, static_cast<int>(i));
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        shouldExit = true;
+    }
+    wakeCV.notify_all();
+
+    for (auto &worker : workers)
+        if (worker.joinable())
+            worker.join();
+}
+
+int JobSystem::currentWorker() const
+{
+    return workerSystem == this ? workerIndex : -1;
+}
+
+JobSystem::JobHandle JobSystem::submit(std::function<void()> task, std::initializer_list<JobHandle> dependencies)
+{
+    auto job = std::make_shared<Job>();
+    job->task = std::move(task);
+    enqueue(job, dependencies);
+    return job;
+}
+
+void JobSystem::enqueue(const JobHandle &job, std::initializer_list<JobHandle> dependencies)
+{
+    job->pending.store(1 + static_cast<int>(dependencies.size()), std::memory_order_relaxed);
+
+    // Finished dependencies count down right away, the rest do so when they finish
+    for (const JobHandle &dependency : dependencies)
+    {
+        std::lock_guard<std::mutex> lock(dependency->mutex);
+        if (dependency->done)
+            job->pending.fetch_sub(1, std::memory_order_acq_rel);
+        else
+            dependency->continuations.push_back(job);
+    }
+
+    if (job->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        schedule(job);
+}
+
+JobSystem::JobHandle JobSystem::acquireJob()
+{
+    {
+        std::lock_guard<std::mutex> lock(freeMutex);
+        if (!freeJobs.empty())
+        {
+            JobHandle job = std::move(freeJobs.back());
+            freeJobs.pop_back();
+            return job;
+        }
+    }
+    return std::make_shared<Job>();
+}
+
+void JobSystem::releaseJob(JobHandle job)
+{
+    // Only finished jobs come back, the worker that ran it may still hold a reference but no longer touches it
+    job->finished.store(false, std::memory_order_relaxed);
+    job->done = false;
+
+    std::lock_guard<std::mutex> lock(freeMutex);
+    freeJobs.push_back(std::move(job));
+}
+
+void JobSystem::Queue::pushBack(JobHandle job)
+{
+    if (count == jobs.size())
+    {
+        // Grow and unwrap, this only happens until the ring fits the busiest moment
+        std::vector<JobHandle> grown(std::max<size_t>(16, 2 * jobs.size()));
+        for (size_t i = 0; i < count; i++)
+            grown[i] = std::move(jobs[(front + i) % jobs.size()]);
+        jobs.swap(grown);
+        front = 0;
+    }
+
+    jobs[(front + count) % jobs.size()] = std::move(job);
+    count++;
+}
+
+JobSystem::JobHandle JobSystem::Queue::popBack()
+{
+    if (count == 0)
+        return nullptr;
+
+    count--;
+    return std::move(jobs[(front + count) % jobs.size()]);
+}
+
+JobSystem::JobHandle JobSystem::Queue::popFront()
+{
+    if (count == 0)
+        return nullptr;
+
+    JobHandle job = std::move(jobs[front]);
+    front = (front + 1) % jobs.size();
+    count--;
+    return job;
+}
+
+void JobSystem::wait(const JobHandle &job)
+{
+    int home = currentWorker();
+
+    while (!job->finished.load(std::memory_order_acquire))
+    {
+        if (JobHandle other = findJob(home))
+        {
+            run(other);
+            continue;
+        }
+
+        // Nothing to steal, whatever the job still needs is running on other threads, so sleep until it is done
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->doneCV.wait(lock, [&]
+                         { return job->done; });
+    }
+}
+
+void JobSystem::schedule(JobHandle job)
+{
+    if (queues.empty())
+    {
+        run(job);
+        return;
+    }
+
+    // Workers keep their own jobs, outside threads spread them round robin
+    int index = currentWorker();
+    if (index < 0)
+        index = static_cast<int>(nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size());
+
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->pushBack(std::move(job));
+    }
+
+    queued.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeCV.notify_one();
+}
+
+JobSystem::JobHandle JobSystem::findJob(int home)
+{
+    // Newest job from the own queue first, it is most likely still in cache
+    if (home >= 0)
+    {
+        Queue &queue = *queues[home];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (JobHandle job = queue.popBack())
+        {
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    // Steal the oldest job of another queue
+    int count = static_cast<int>(queues.size());
+    int start = home >= 0 ? home + 1 : 0;
+    for (int i = 0; i < count; i++)
+    {
+        Queue &queue = *queues[(start + i) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (JobHandle job = queue.popFront())
+        {
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
+void JobSystem::run(const JobHandle &job)
+{
+    job->task();
+    job->task = nullptr;
+
+    std::vector<JobHandle> continuations;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->done = true;
+        continuations.swap(job->continuations);
+        job->finished.store(true, std::memory_order_release);
+
+        // Sleeping waiters wake with done and finished both set
+        job->doneCV.notify_all();
+    }
+
+    for (JobHandle &continuation : continuations)
+        if (continuation->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            schedule(std::move(continuation));
+}
+
+void JobSystem::workerLoop(int index)
+{
+    workerSystem = this;
+    workerIndex = index;
+
+    while (true)
+    {
+        if (JobHandle job = findJob(index))
+        {
+            run(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeCV.wait(lock, [&]
+                    { return shouldExit || queued.load(std::memory_order_acquire) > 0; });
+
+        if (shouldExit)
+            return;
+    }
+}
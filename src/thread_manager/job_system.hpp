@@ -0,0 +1,140 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+// Persistent threads that run small jobs, each worker has its own deque and idle workers steal from the others
+class JobSystem
+{
+public:
+    struct Job
+    {
+        std::function<void()> task;
+
+        // Unfinished dependencies, plus one while the job is being submitted
+        std::atomic<int> pending{1};
+        std::atomic<bool> finished{false};
+
+        // Jobs waiting on this one, guarded by mutex until done is set
+        std::mutex mutex;
+        bool done = false;
+        std::vector<std::shared_ptr<Job>> continuations;
+
+        // Threads in wait sleep on this once there is nothing left to steal
+        std::condition_variable doneCV;
+    };
+    using JobHandle = std::shared_ptr<Job>;
+
+    explicit JobSystem(unsigned threadCount);
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    // Number of threads that can run jobs, including a waiting caller
+    unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    // Queue task, it runs once all dependencies have finished
+    JobHandle submit(std::function<void()> task, std::initializer_list<JobHandle> dependencies = {});
+
+    // Block until job has finished, running other jobs in the meantime and sleeping when there are none
+    void wait(const JobHandle &job);
+
+    // Call function(i) for every i in [0, count), handed out in chunks of grainSize, returns once all are done
+    template <typename Function>
+    void parallelFor(int count, int grainSize, Function &&function)
+    {
+        if (count <= 0)
+            return;
+
+        grainSize = std::max(grainSize, 1);
+        int chunkCount = (count + grainSize - 1) / grainSize;
+
+        // Not worth waking anyone
+        if (chunkCount == 1 || workers.empty())
+        {
+            for (int i = 0; i < count; i++)
+                function(i);
+            return;
+        }
+
+        // Every job takes chunks until none are left, so a slow chunk does not hold up the rest
+        std::atomic<int> nextChunk{0};
+        auto runChunks = [&]()
+        {
+            int chunk;
+            while ((chunk = nextChunk.fetch_add(1, std::memory_order_relaxed)) < chunkCount)
+            {
+                int end = std::min(count, (chunk + 1) * grainSize);
+                for (int i = chunk * grainSize; i < end; i++)
+                    function(i);
+            }
+        };
+
+        // Jobs come from a free list, so a steady stream of calls does not allocate
+        int jobCount = std::min({chunkCount - 1, static_cast<int>(workers.size()), maxParallelJobs});
+        JobHandle jobs[maxParallelJobs];
+        for (int j = 0; j < jobCount; j++)
+        {
+            jobs[j] = acquireJob();
+            jobs[j]->task = [run = &runChunks]()
+            { (*run)(); };
+            enqueue(jobs[j], {});
+        }
+
+        runChunks();
+
+        for (int j = 0; j < jobCount; j++)
+        {
+            wait(jobs[j]);
+            releaseJob(std::move(jobs[j]));
+        }
+    }
+
+private:
+    static constexpr int maxParallelJobs = 64;
+
+    // Ring of jobs, the owner works on the back and thieves take from the front
+    struct Queue
+    {
+        std::mutex mutex;
+        std::vector<JobHandle> jobs;
+        size_t front = 0, count = 0;
+
+        void pushBack(JobHandle job);
+        JobHandle popBack();
+        JobHandle popFront();
+    };
+
+    void enqueue(const JobHandle &job, std::initializer_list<JobHandle> dependencies);
+    JobHandle acquireJob();
+    void releaseJob(JobHandle job);
+
+    void schedule(JobHandle job);
+    JobHandle findJob(int home);
+    void run(const JobHandle &job);
+    void workerLoop(int index);
+
+    // Index of the calling thread's own queue, -1 for threads outside the system
+    int currentWorker() const;
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::atomic<unsigned> nextQueue{0};
+
+    std::mutex freeMutex;
+    std::vector<JobHandle> freeJobs;
+
+    // Idle workers sleep until something is queued
+    std::mutex sleepMutex;
+    std::condition_variable wakeCV;
+    std::atomic<int> queued{0};
+    bool shouldExit = false;
+};
@@ -4,6 +4,14 @@
 
 void ThreadManager::startup()
 {
+    // Leave a core for the main thread and split the rest, physics and the jobs run at the same time
+    // The physics thread takes part in its pool, a waiting prep or animation thread in the job system
+    unsigned cores = std::max(2u, std::thread::hardware_concurrency());
+    unsigned physicsThreads = std::max(1u, (cores - 1) / 2);
+    unsigned jobThreads = std::max(1u, cores - 1 - physicsThreads);
+    physicsPool = std::make_unique<WorkerPool>(physicsThreads);
+    jobSystem = std::make_unique<JobSystem>(jobThreads);
+
     physicsThread = std::thread(physicsThreadFunction);
     animationThread = std::thread(animationThreadFunction);
     renderBufferThread = std::thread(renderBufferThreadFunction);
@@ -35,6 +43,9 @@ void ThreadManager::shutdown()
         animationThread.join();
     if (renderBufferThread.joinable())
         renderBufferThread.join();
+
+    physicsPool.reset();
+    jobSystem.reset();
 }
 
 void ThreadManager::physicsThreadFunction()
@@ -50,14 +61,8 @@ void ThreadManager::physicsThreadFunction()
 
         physicsTrigger = false;
 
-        for (ModelData &model : SceneManager::currentScene.get()->structModels)
-        {
-            if (model.physics.has_value())
-            {
-                model.physics->getWriteBuffer()->copyFrom(*model.physics->getReadBuffer());
-                model.physics->getWriteBuffer()->savePrevState();
-            }
-        }
+        PhysicsWorld &world = SceneManager::currentScene->physicsWorld;
+        world.beginTicks();
 
         while (true)
         {
@@ -67,27 +72,13 @@ void ThreadManager::physicsThreadFunction()
 
             if (physicsSteps.compare_exchange_weak(oldSteps, oldSteps - 1))
             {
-                for (ModelData &model : SceneManager::currentScene.get()->structModels)
-                {
-                    if (model.physics.has_value())
-                    {
-                        PhysicsUtil::stepPhysics(model);
-                    }
-                }
+                PhysicsUtil::stepPhysics(world, physicsPool.get());
 
                 PhysicsUtil::accumulator.store(PhysicsUtil::accumulator.load(std::memory_order_acquire) - (1 / SettingsManager::settings.physics.tickRate));
             }
         }
 
-        for (auto &model : SceneManager::currentScene->structModels)
-        {
-            PhysicsUtil::isSwapping.store(true, std::memory_order_release);
-
-            if (model.physics)
-                model.physics->swapBuffers();
-
-            PhysicsUtil::isSwapping.store(false, std::memory_order_release);
-        }
+        world.publish();
 
         ThreadManager::physicsBusy.store(false, std::memory_order_release);
     }
@@ -108,30 +99,22 @@ void ThreadManager::animationThreadFunction()
         lock.unlock();
 
         float alpha = animationAlpha.load(std::memory_order_acquire);
-        bool didAnimate = false;
 
         // Check if scene is valid before proceeding
         auto scenePtr = SceneManager::currentScene.get();
         if (scenePtr)
         {
-            // Run animations sequentially for all models
-            for (ModelData &model : scenePtr->structModels)
-            {
-                if (model.animated)
-                {
-                    auto &writeBones = model.model->getWriteBuffer();
-                    Animation::update(model, alpha, writeBones);
-                    didAnimate = true;
-                }
-                else if (model.physics.has_value())
-                {
-                    Animation::update(model, alpha);
-                }
-            }
-        }
+            // Newest physics state, the same snapshot is used for every model
+            scenePtr->physicsWorld.acquireReadState();
+
+            // Every model writes only its own transform and palette, so they are spread over the job system
+            std::vector<ModelData> &models = scenePtr->structModels;
+            Animation::posedModels.store(0, std::memory_order_relaxed);
+            Animation::skippedModels.store(0, std::memory_order_relaxed);
 
-        if (didAnimate)
-            ModelUtil::swapBoneBuffers();
+            jobSystem->parallelFor(static_cast<int>(models.size()), 8, [&](int i)
+                                   { Animation::update(models[i], alpha); });
+        }
 
         lock.lock();
         animationDoneWriting = true;
@@ -4,6 +4,10 @@
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <memory>
+
+#include "thread_manager/worker_pool.hpp"
+#include "thread_manager/job_system.hpp"
 
 namespace ThreadManager
 {
@@ -19,6 +23,10 @@ namespace ThreadManager
     inline std::atomic<int> physicsSteps(0);
     inline std::atomic<bool> physicsBusy(false);
     inline std::atomic<bool> physicsShouldExit(false);
+    inline std::unique_ptr<WorkerPool> physicsPool;
+
+    // Short jobs from render prep and loading
+    inline std::unique_ptr<JobSystem> jobSystem;
 
     inline std::mutex animationMutex;
     inline std::atomic<float> animationAlpha(0.0f);
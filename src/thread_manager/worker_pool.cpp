@@ -0,0 +1,93 @@
+#include "thread_manager/worker_pool.hpp"
+
+WorkerPool::WorkerPool(unsigned threadCount)
+{
+    // The calling thread is the first worker
+    for (unsigned i = 1; i < threadCount; i++)
+        workers.emplace_back(&WorkerPool::workerLoop, this);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        shouldExit = true;
+    }
+    wakeCV.notify_all();
+
+    for (auto &worker : workers)
+        if (worker.joinable())
+            worker.join();
+}
+
+void WorkerPool::dispatch(int chunkCount, void (*function)(void *, int), void *context)
+{
+    if (chunkCount <= 0)
+        return;
+
+    // Not worth waking anyone
+    if (chunkCount == 1 || workers.empty())
+    {
+        for (int chunk = 0; chunk < chunkCount; chunk++)
+            function(context, chunk);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        taskFunction = function;
+        taskContext = context;
+        taskChunks = chunkCount;
+        nextChunk.store(0, std::memory_order_release);
+        generation++;
+    }
+    wakeCV.notify_all();
+
+    runChunks();
+
+    // Barrier, wait until no other thread is still inside this task
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCV.wait(lock, [&]
+                { return activeWorkers == 0; });
+}
+
+void WorkerPool::runChunks()
+{
+    while (true)
+    {
+        // Acquire pairs with the reset in dispatch, so the task is visible here
+        int chunk = nextChunk.fetch_add(1, std::memory_order_acquire);
+        if (chunk >= taskChunks)
+            break;
+
+        taskFunction(taskContext, chunk);
+    }
+}
+
+void WorkerPool::workerLoop()
+{
+    uint64_t seenGeneration = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCV.wait(lock, [&]
+                        { return shouldExit || generation != seenGeneration; });
+
+            if (shouldExit)
+                return;
+
+            seenGeneration = generation;
+            activeWorkers++;
+        }
+
+        runChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            activeWorkers--;
+        }
+        doneCV.notify_one();
+    }
+}
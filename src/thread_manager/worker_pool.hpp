@@ -0,0 +1,52 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+
+// Fixed set of threads that run chunked tasks, the calling thread helps out
+class WorkerPool
+{
+public:
+    explicit WorkerPool(unsigned threadCount);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    // Number of threads working on a task, including the caller
+    unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    // Run task(chunk) for every chunk, returns once all chunks are done
+    template <typename Task>
+    void run(int chunkCount, Task &task)
+    {
+        dispatch(chunkCount, &invoke<Task>, &task);
+    }
+
+private:
+    template <typename Task>
+    static void invoke(void *task, int chunk) { (*static_cast<Task *>(task))(chunk); }
+
+    void dispatch(int chunkCount, void (*function)(void *, int), void *context);
+    void workerLoop();
+    void runChunks();
+
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wakeCV;
+    std::condition_variable doneCV;
+    uint64_t generation = 0;
+    int activeWorkers = 0;
+    bool shouldExit = false;
+
+    // Current task
+    void (*taskFunction)(void *, int) = nullptr;
+    void *taskContext = nullptr;
+    int taskChunks = 0;
+    std::atomic<int> nextChunk{0};
+};
@@ -362,6 +362,7 @@ void Slider::Update()
 
                 Render::renderMenu(SceneManager::engineState);
                 glfwPollEvents();
+                Render::endFrame();
                 glfwSwapBuffers(WindowManager::window);
             }
         break;